@@ -1,10 +1,36 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <errno.h>
+#include <termios.h>
+#include <sys/epoll.h>
+#endif
 
 #define MAX_GPS_DATA_LEN 100
 #define NMEA_SENTENCE_LEN 80
+#define NMEA_MAX_FIELDS 24
+#define NMEA_BENCHMARK_ITERATIONS 1000000
+#define NMEA_INGEST_THREADS 4
+#define NMEA_PROGRESS_BYTES (1 << 20)
+#define MAX_SERIAL_DEVICES 64
+#define SERIAL_READ_CHUNK 256
+#define SENTENCE_QUEUE_CAPACITY 128
+#define SERIAL_ENQUEUE_TIMEOUT_MS 50
+#define SERIAL_DEMO_DEVICES 3
+#define SERIAL_DEMO_SENTENCES 5
 
 char gps_data[MAX_GPS_DATA_LEN];
 char nmea_sentence[NMEA_SENTENCE_LEN];
@@ -17,39 +43,123 @@ typedef struct {
     char status;   
 } GPS_Data;
 
+// Non-owning view into a sentence buffer; the parser never writes to the input.
+typedef struct {
+    const char *data;
+    size_t length;
+} NMEASpan;
+
+// Column-per-field fix storage for bulk ingestion.
+typedef struct {
+    float *latitude;
+    float *longitude;
+    float *altitude;
+    char (*time)[11];
+    char *status;
+    size_t count;
+    size_t capacity;
+} GPSColumns;
+
+typedef struct {
+    const char *begin;
+    const char *end;
+    GPSColumns columns;
+    long parsed;
+    long rejected;
+    atomic_size_t *bytesDone;
+    atomic_int *workersDone;
+} NMEAIngestChunk;
+
+#ifdef __linux__
+// Per-device reassembly buffer: bytes accumulate until a line terminator completes the
+// sentence, however the driver happened to split the reads.
+typedef struct {
+    int fd;
+    char path[64];
+    char buffer[MAX_GPS_DATA_LEN];
+    size_t used;
+    long sentences;
+    long overlong;
+    bool open;
+} SerialDevice;
+
+typedef struct {
+    char sentences[SENTENCE_QUEUE_CAPACITY][MAX_GPS_DATA_LEN];
+    int devices[SENTENCE_QUEUE_CAPACITY];
+    int head;
+    int count;
+    long dropped;
+    bool closed;
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+} SentenceQueue;
+
+SerialDevice serialDevices[MAX_SERIAL_DEVICES];
+SentenceQueue sentenceQueue;
+
+void runSerialDevices(int count, char **paths);
+void runPseudoTerminalDemo(void);
+#endif
 
 void initGPSData(GPS_Data *gps);
-bool parseNMEASentence(char *nmea, GPS_Data *gps);
-void extractDataFromSentence(char *nmea, GPS_Data *gps);
+NMEASpan makeNMEASpan(const char *text);
+bool parseNMEASentence(NMEASpan nmea, GPS_Data *gps);
+int splitNMEAFields(NMEASpan body, NMEASpan *fields, int maxFields);
+void extractDataFromSentence(NMEASpan *fields, int fieldCount, GPS_Data *gps);
+void extractRMCData(NMEASpan *fields, int fieldCount, GPS_Data *gps);
 void processGPSData(GPS_Data *gps);
 void printGPSData(GPS_Data *gps);
 void handleSerialInput(void);
 void processData(char *data);
 void initializeParser(void);
-bool validateChecksum(char *nmea);
-void processLongitude(char *longitude, char hemisphere, GPS_Data *gps);
-void processLatitude(char *latitude, char hemisphere, GPS_Data *gps);
-void extractTime(char *time_str, GPS_Data *gps);
-void processAltitude(char *altitude_str, GPS_Data *gps);
-void processStatus(char *status_str, GPS_Data *gps);
+bool validateChecksum(NMEASpan nmea);
+double parseNMEADecimal(NMEASpan field);
+double parseNMEACoordinate(NMEASpan field, NMEASpan hemisphere);
+void processLongitude(NMEASpan longitude, NMEASpan hemisphere, GPS_Data *gps);
+void processLatitude(NMEASpan latitude, NMEASpan hemisphere, GPS_Data *gps);
+void extractTime(NMEASpan time_str, GPS_Data *gps);
+void processAltitude(NMEASpan altitude_str, GPS_Data *gps);
+void processStatus(NMEASpan status_str, GPS_Data *gps);
+void benchmarkNMEAParser(int iterations);
+void initGPSColumns(GPSColumns *columns, size_t capacity);
+void freeGPSColumns(GPSColumns *columns);
+bool appendGPSColumns(GPSColumns *columns, const GPS_Data *gps);
+bool ingestNMEALog(const char *path, GPSColumns *station);
+void ingestNMEALogs(int count, char **paths);
 void storeNMEASentence(char *sentence);
 void parseAdditionalFields(char *field_data, GPS_Data *gps);
 
-int main(void) {
+int main(int argc, char **argv) {
+#ifdef __linux__
+    if (argc > 2 && strcmp(argv[1], "--serial") == 0) {
+        runSerialDevices(argc - 2, argv + 2);
+        return 0;
+    }
+#endif
+    if (argc > 1) {
+        ingestNMEALogs(argc - 1, argv + 1);
+        return 0;
+    }
+    benchmarkNMEAParser(NMEA_BENCHMARK_ITERATIONS);
+#ifdef __linux__
+    runPseudoTerminalDemo();
+#else
     while (1) {
         handleSerialInput();
     }
+#endif
     return 0;
 }
 
 void handleSerialInput(void) {
-    strcpy(gps_data, "$GPGGA,123456.789,3751.65,S,14504.00,E,1,08,1.0,10.0,M,0.0,M,,*47");
+    strcpy(gps_data, "$GPGGA,123456.789,3751.65,S,14504.00,E,1,08,1.0,10.0,M,0.0,M,,*4F");
     printf("Received GPS Data: %s\n", gps_data);
     
     GPS_Data gps;
     initGPSData(&gps);
 
-    if (parseNMEASentence(gps_data, &gps)) {
+    if (parseNMEASentence(makeNMEASpan(gps_data), &gps)) {
         processGPSData(&gps);
     } else {
         printf("Invalid NMEA sentence.\n");
@@ -64,80 +174,722 @@ void initGPSData(GPS_Data *gps) {
     gps->status = 'V';
 }
 
-bool parseNMEASentence(char *nmea, GPS_Data *gps) {
-    if (nmea == NULL) {
+NMEASpan makeNMEASpan(const char *text) {
+    NMEASpan span;
+    span.data = text;
+    span.length = strlen(text);
+    return span;
+}
+
+// Accepts GGA and RMC from any talker ($GP, $GN, $GL, ...) once the checksum matches.
+bool parseNMEASentence(NMEASpan nmea, GPS_Data *gps) {
+    NMEASpan fields[NMEA_MAX_FIELDS];
+    if (nmea.data == NULL) {
+        return false;
+    }
+    while (nmea.length > 0 && (nmea.data[nmea.length - 1] == '\n' || nmea.data[nmea.length - 1] == '\r')) {
+        nmea.length--;
+    }
+    if (nmea.length < 7 || nmea.data[0] != '$' || !validateChecksum(nmea)) {
+        return false;
+    }
+
+    int fieldCount = splitNMEAFields(nmea, fields, NMEA_MAX_FIELDS);
+    if (fields[0].length != 5) {
         return false;
     }
-    if (strncmp(nmea, "$GPGGA", 6) == 0) {
-        extractDataFromSentence(nmea, gps);
+    if (memcmp(fields[0].data + 2, "GGA", 3) == 0) {
+        extractDataFromSentence(fields, fieldCount, gps);
+        return true;
+    }
+    if (memcmp(fields[0].data + 2, "RMC", 3) == 0) {
+        extractRMCData(fields, fieldCount, gps);
         return true;
     }
     return false;
 }
 
-void extractDataFromSentence(char *nmea, GPS_Data *gps) {
-    char *token;
-    int field_count = 0;
-    token = strtok(nmea, ",");
-    
-    while (token != NULL) {
-        field_count++;
-        if (field_count == 2) {
-            extractTime(token, gps);
+// SWAR: eight bytes are tested at once for ',' or '*' with the has-zero-byte trick,
+// and the exact position is then found bytewise in the word that matched.
+#define BYTES_EQUAL_TO(x, c) ((x) ^ (0x0101010101010101ULL * (unsigned char)(c)))
+#define HAS_ZERO_BYTE(x) (((x) - 0x0101010101010101ULL) & ~(x) & 0x8080808080808080ULL)
+
+size_t findFieldDelimiter(const char *data, size_t length) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (HAS_ZERO_BYTE(BYTES_EQUAL_TO(word, ',')) | HAS_ZERO_BYTE(BYTES_EQUAL_TO(word, '*'))) {
+            break;
+        }
+    }
+    for (; i < length; i++) {
+        if (data[i] == ',' || data[i] == '*') {
+            return i;
         }
-        if (field_count == 3) {
-            processLatitude(token, 'N', gps);
+    }
+    return length;
+}
+
+// Splits the sentence after '$' and up to '*' into field spans. Field 0 is the address,
+// e.g. "GPGGA". Returns the number of fields found.
+int splitNMEAFields(NMEASpan body, NMEASpan *fields, int maxFields) {
+    const char *p = body.data + 1;
+    const char *end = body.data + body.length;
+    int count = 0;
+
+    while (count < maxFields) {
+        size_t n = findFieldDelimiter(p, (size_t)(end - p));
+        fields[count].data = p;
+        fields[count].length = n;
+        count++;
+        if (p + n >= end || p[n] == '*') {
+            break;
+        }
+        p += n + 1;
+    }
+    return count;
+}
+
+void extractDataFromSentence(NMEASpan *fields, int fieldCount, GPS_Data *gps) {
+    if (fieldCount > 1) {
+        extractTime(fields[1], gps);
+    }
+    if (fieldCount > 3) {
+        processLatitude(fields[2], fields[3], gps);
+    }
+    if (fieldCount > 5) {
+        processLongitude(fields[4], fields[5], gps);
+    }
+    if (fieldCount > 6) {
+        processStatus(fields[6], gps);
+    }
+    if (fieldCount > 9) {
+        processAltitude(fields[9], gps);
+    }
+}
+
+void extractRMCData(NMEASpan *fields, int fieldCount, GPS_Data *gps) {
+    if (fieldCount > 1) {
+        extractTime(fields[1], gps);
+    }
+    if (fieldCount > 2) {
+        gps->status = (fields[2].length == 1 && fields[2].data[0] == 'A') ? 'A' : 'V';
+    }
+    if (fieldCount > 4) {
+        processLatitude(fields[3], fields[4], gps);
+    }
+    if (fieldCount > 6) {
+        processLongitude(fields[5], fields[6], gps);
+    }
+}
+
+// Plain decimal without exponent, as used by every NMEA numeric field. Digits are
+// accumulated as an integer and scaled once, avoiding atof's locale and strtod paths.
+double parseNMEADecimal(NMEASpan field) {
+    static const double negativePowers[] = {1e0, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9,
+                                            1e-10, 1e-11, 1e-12, 1e-13, 1e-14, 1e-15, 1e-16, 1e-17, 1e-18};
+    size_t i = 0;
+    bool negative = false;
+    uint64_t mantissa = 0;
+    int fractionDigits = 0;
+    int digits = 0;
+
+    if (i < field.length && (field.data[i] == '-' || field.data[i] == '+')) {
+        negative = field.data[i] == '-';
+        i++;
+    }
+    for (; i < field.length && field.data[i] >= '0' && field.data[i] <= '9'; i++) {
+        mantissa = mantissa * 10 + (uint64_t)(field.data[i] - '0');
+        digits++;
+    }
+    if (i < field.length && field.data[i] == '.') {
+        for (i++; i < field.length && field.data[i] >= '0' && field.data[i] <= '9'; i++) {
+            if (digits < 18) {
+                mantissa = mantissa * 10 + (uint64_t)(field.data[i] - '0');
+                digits++;
+                fractionDigits++;
+            }
+        }
+    }
+    double value = (double)mantissa * negativePowers[fractionDigits];
+    return negative ? -value : value;
+}
+
+// ddmm.mmmm / dddmm.mmmm to signed decimal degrees.
+double parseNMEACoordinate(NMEASpan field, NMEASpan hemisphere) {
+    double raw = parseNMEADecimal(field);
+    int degrees = (int)(raw / 100.0);
+    double value = degrees + (raw - degrees * 100.0) / 60.0;
+    if (hemisphere.length == 1 && (hemisphere.data[0] == 'S' || hemisphere.data[0] == 'W')) {
+        value = -value;
+    }
+    return value;
+}
+
+void processLongitude(NMEASpan longitude, NMEASpan hemisphere, GPS_Data *gps) {
+    gps->longitude = (float)parseNMEACoordinate(longitude, hemisphere);
+}
+
+void processLatitude(NMEASpan latitude, NMEASpan hemisphere, GPS_Data *gps) {
+    gps->latitude = (float)parseNMEACoordinate(latitude, hemisphere);
+}
+
+void extractTime(NMEASpan time_str, GPS_Data *gps) {
+    size_t n = time_str.length < 10 ? time_str.length : 10;
+    memcpy(gps->time, time_str.data, n);
+    gps->time[n] = '\0';
+}
+
+void processAltitude(NMEASpan altitude_str, GPS_Data *gps) {
+    gps->altitude = (float)parseNMEADecimal(altitude_str);
+}
+
+void processStatus(NMEASpan status_str, GPS_Data *gps) {
+    if (status_str.length == 1 && status_str.data[0] >= '1' && status_str.data[0] <= '8') {
+        gps->status = 'A';
+    } else {
+        gps->status = 'V';
+    }
+}
+
+void benchmarkNMEAParser(int iterations) {
+    const char *samples[] = {
+        "$GPGGA,123456.789,3751.65,S,14504.00,E,1,08,1.0,10.0,M,0.0,M,,*4F",
+        "$GPRMC,123456.789,A,3751.65,S,14504.00,E,1.0,10.0,190326,,,A*4A",
+        "$GPGGA,122233.789,3456.65,N,12345.00,E,1,08,1.0,20.0,M,0.0,M,,*54"
+    };
+    NMEASpan spans[3];
+    GPS_Data gps;
+    int parsed = 0;
+
+    for (int i = 0; i < 3; i++) {
+        spans[i] = makeNMEASpan(samples[i]);
+    }
+    clock_t start = clock();
+    for (int i = 0; i < iterations; i++) {
+        parsed += parseNMEASentence(spans[i % 3], &gps);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("NMEA parser: %d of %d sentences valid, %.0f sentences per second\n",
+           parsed, iterations, seconds > 0 ? iterations / seconds : 0.0);
+}
+
+void initGPSColumns(GPSColumns *columns, size_t capacity) {
+    columns->latitude = (float *)malloc(capacity * sizeof(float));
+    columns->longitude = (float *)malloc(capacity * sizeof(float));
+    columns->altitude = (float *)malloc(capacity * sizeof(float));
+    columns->time = (char (*)[11])malloc(capacity * sizeof(*columns->time));
+    columns->status = (char *)malloc(capacity);
+    columns->count = 0;
+    columns->capacity = capacity;
+}
+
+void freeGPSColumns(GPSColumns *columns) {
+    free(columns->latitude);
+    free(columns->longitude);
+    free(columns->altitude);
+    free(columns->time);
+    free(columns->status);
+    columns->count = 0;
+    columns->capacity = 0;
+}
+
+bool appendGPSColumns(GPSColumns *columns, const GPS_Data *gps) {
+    if (columns->count == columns->capacity) {
+        size_t capacity = columns->capacity * 2 + 16;
+        float *latitude = (float *)realloc(columns->latitude, capacity * sizeof(float));
+        if (latitude != NULL) {
+            columns->latitude = latitude;
         }
-        if (field_count == 4) {
-            processLatitude(token, 'S', gps);
+        float *longitude = (float *)realloc(columns->longitude, capacity * sizeof(float));
+        if (longitude != NULL) {
+            columns->longitude = longitude;
         }
-        if (field_count == 5) {
-            processLongitude(token, 'E', gps);
+        float *altitude = (float *)realloc(columns->altitude, capacity * sizeof(float));
+        if (altitude != NULL) {
+            columns->altitude = altitude;
         }
-        if (field_count == 6) {
-            processLongitude(token, 'W', gps);
+        char (*timeColumn)[11] = (char (*)[11])realloc(columns->time, capacity * sizeof(*columns->time));
+        if (timeColumn != NULL) {
+            columns->time = timeColumn;
         }
-        if (field_count == 10) {
-            processAltitude(token, gps);
+        char *status = (char *)realloc(columns->status, capacity);
+        if (status != NULL) {
+            columns->status = status;
         }
-        if (field_count == 7) {
-            processStatus(token, gps);
+        if (latitude == NULL || longitude == NULL || altitude == NULL || timeColumn == NULL || status == NULL) {
+            return false;
         }
-        token = strtok(NULL, ",");
+        columns->capacity = capacity;
     }
+    size_t i = columns->count++;
+    columns->latitude[i] = gps->latitude;
+    columns->longitude[i] = gps->longitude;
+    columns->altitude[i] = gps->altitude;
+    memcpy(columns->time[i], gps->time, sizeof(gps->time));
+    columns->status[i] = gps->status;
+    return true;
 }
 
-void processLongitude(char *longitude, char hemisphere, GPS_Data *gps) {
-    gps->longitude = atof(longitude);
-    if (hemisphere == 'W') {
-        gps->longitude = -gps->longitude;
+// Parses every line of one chunk. Chunks start right after a newline and end on one,
+// so no sentence is split between workers.
+void *nmeaIngestWorker(void *arg) {
+    NMEAIngestChunk *chunk = (NMEAIngestChunk *)arg;
+    const char *p = chunk->begin;
+    size_t sinceReport = 0;
+
+    while (p < chunk->end) {
+        const char *newline = memchr(p, '\n', (size_t)(chunk->end - p));
+        const char *lineEnd = newline != NULL ? newline : chunk->end;
+        NMEASpan line;
+        line.data = p;
+        line.length = (size_t)(lineEnd - p);
+
+        if (line.length > 0) {
+            GPS_Data gps;
+            initGPSData(&gps);
+            if (parseNMEASentence(line, &gps) && appendGPSColumns(&chunk->columns, &gps)) {
+                chunk->parsed++;
+            } else {
+                chunk->rejected++;
+            }
+        }
+
+        sinceReport += (size_t)(lineEnd - p) + 1;
+        if (sinceReport >= NMEA_PROGRESS_BYTES) {
+            atomic_fetch_add_explicit(chunk->bytesDone, sinceReport, memory_order_relaxed);
+            sinceReport = 0;
+        }
+        p = lineEnd + 1;
     }
+    atomic_fetch_add_explicit(chunk->bytesDone, sinceReport, memory_order_relaxed);
+    atomic_fetch_add_explicit(chunk->workersDone, 1, memory_order_release);
+    return NULL;
 }
 
-void processLatitude(char *latitude, char hemisphere, GPS_Data *gps) {
-    gps->latitude = atof(latitude);
-    if (hemisphere == 'S') {
-        gps->latitude = -gps->latitude;
+const char *mapNMEALog(const char *path, size_t *length) {
+#ifdef _WIN32
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *buffer = (char *)malloc(size > 0 ? (size_t)size : 1);
+    if (buffer == NULL || fread(buffer, 1, (size_t)size, file) != (size_t)size) {
+        free(buffer);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    *length = (size_t)size;
+    return buffer;
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return NULL;
     }
+    void *mapped = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return NULL;
+    }
+    madvise(mapped, (size_t)info.st_size, MADV_SEQUENTIAL);
+    *length = (size_t)info.st_size;
+    return (const char *)mapped;
+#endif
 }
 
-void extractTime(char *time_str, GPS_Data *gps) {
-    strncpy(gps->time, time_str, 10);
-    gps->time[10] = '\0';
+void unmapNMEALog(const char *data, size_t length) {
+#ifdef _WIN32
+    (void)length;
+    free((void *)data);
+#else
+    munmap((void *)data, length);
+#endif
 }
 
-void processAltitude(char *altitude_str, GPS_Data *gps) {
-    gps->altitude = atof(altitude_str);
+double elapsedSeconds(struct timespec start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start.tv_sec) + (now.tv_nsec - start.tv_nsec) / 1e9;
 }
 
-void processStatus(char *status_str, GPS_Data *gps) {
-    if (strcmp(status_str, "1") == 0) {
-        gps->status = 'A';
-    } else {
-        gps->status = 'V';
+// Splits the mapped log into one chunk per worker at line boundaries, parses them in
+// parallel into per-chunk columns, then concatenates the chunks in file order so the
+// station's output keeps the order of the recording.
+bool ingestNMEALog(const char *path, GPSColumns *station) {
+    NMEAIngestChunk chunks[NMEA_INGEST_THREADS];
+    pthread_t workers[NMEA_INGEST_THREADS];
+    bool started[NMEA_INGEST_THREADS];
+    atomic_size_t bytesDone;
+    atomic_int workersDone;
+    struct timespec start;
+    size_t length = 0;
+    long parsed = 0;
+    long rejected = 0;
+
+    const char *data = mapNMEALog(path, &length);
+    if (data == NULL) {
+        printf("Error opening NMEA log %s.\n", path);
+        return false;
+    }
+    atomic_init(&bytesDone, 0);
+    atomic_init(&workersDone, 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    const char *cursor = data;
+    const char *end = data + length;
+    for (int t = 0; t < NMEA_INGEST_THREADS; t++) {
+        const char *chunkEnd = (t == NMEA_INGEST_THREADS - 1) ? end : data + length / NMEA_INGEST_THREADS * (t + 1);
+        if (chunkEnd < cursor) {
+            chunkEnd = cursor;
+        }
+        const char *newline = memchr(chunkEnd, '\n', (size_t)(end - chunkEnd));
+        chunkEnd = (newline != NULL && t < NMEA_INGEST_THREADS - 1) ? newline + 1 : end;
+
+        chunks[t].begin = cursor;
+        chunks[t].end = chunkEnd;
+        chunks[t].parsed = 0;
+        chunks[t].rejected = 0;
+        chunks[t].bytesDone = &bytesDone;
+        chunks[t].workersDone = &workersDone;
+        initGPSColumns(&chunks[t].columns, (size_t)(chunkEnd - cursor) / 64 + 16);
+        cursor = chunkEnd;
+    }
+
+    for (int t = 0; t < NMEA_INGEST_THREADS; t++) {
+        started[t] = pthread_create(&workers[t], NULL, nmeaIngestWorker, &chunks[t]) == 0;
+        if (!started[t]) {
+            nmeaIngestWorker(&chunks[t]);
+        }
+    }
+
+    for (int tick = 1; atomic_load_explicit(&workersDone, memory_order_acquire) < NMEA_INGEST_THREADS; tick++) {
+        struct timespec interval = {0, 10000000L};
+        nanosleep(&interval, NULL);
+        if (tick % 20 == 0) {
+            size_t done = atomic_load_explicit(&bytesDone, memory_order_relaxed);
+            printf("%s: %.1f%% (%.1f MB/s)\n", path, 100.0 * done / length, done / 1e6 / elapsedSeconds(start));
+        }
+    }
+
+    for (int t = 0; t < NMEA_INGEST_THREADS; t++) {
+        if (started[t]) {
+            pthread_join(workers[t], NULL);
+        }
+    }
+    double seconds = elapsedSeconds(start);
+
+    size_t total = 0;
+    for (int t = 0; t < NMEA_INGEST_THREADS; t++) {
+        total += chunks[t].columns.count;
+    }
+    initGPSColumns(station, total + 1);
+    for (int t = 0; t < NMEA_INGEST_THREADS; t++) {
+        GPSColumns *columns = &chunks[t].columns;
+        size_t at = station->count;
+        memcpy(station->latitude + at, columns->latitude, columns->count * sizeof(float));
+        memcpy(station->longitude + at, columns->longitude, columns->count * sizeof(float));
+        memcpy(station->altitude + at, columns->altitude, columns->count * sizeof(float));
+        memcpy(station->time + at, columns->time, columns->count * sizeof(*columns->time));
+        memcpy(station->status + at, columns->status, columns->count);
+        station->count += columns->count;
+        parsed += chunks[t].parsed;
+        rejected += chunks[t].rejected;
+        freeGPSColumns(&chunks[t].columns);
+    }
+    unmapNMEALog(data, length);
+
+    printf("%s: %ld sentences parsed, %ld rejected, %.2f s, %.1f MB/s, %.0f sentences per second\n",
+           path, parsed, rejected, seconds, length / 1e6 / (seconds > 0 ? seconds : 1e-9),
+           (parsed + rejected) / (seconds > 0 ? seconds : 1e-9));
+    return true;
+}
+
+// Batch mode: every argument is one station's recorded NMEA log.
+void ingestNMEALogs(int count, char **paths) {
+    for (int s = 0; s < count; s++) {
+        GPSColumns station;
+        if (!ingestNMEALog(paths[s], &station)) {
+            continue;
+        }
+        if (station.count > 0) {
+            size_t last = station.count - 1;
+            printf("Station %s: %zu fixes, first %s (%.5f, %.5f), last %s (%.5f, %.5f)\n",
+                   paths[s], station.count,
+                   station.time[0], station.latitude[0], station.longitude[0],
+                   station.time[last], station.latitude[last], station.longitude[last]);
+        }
+        freeGPSColumns(&station);
+    }
+}
+
+#ifdef __linux__
+void initSentenceQueue(SentenceQueue *queue) {
+    queue->head = 0;
+    queue->count = 0;
+    queue->dropped = 0;
+    queue->closed = false;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->notEmpty, NULL);
+    pthread_cond_init(&queue->notFull, NULL);
+}
+
+// Blocks for up to SERIAL_ENQUEUE_TIMEOUT_MS while the parser is behind. While the
+// reader waits here it stops draining the devices, so the tty buffers absorb the
+// burst; only if the parser stays stalled past the deadline is the sentence dropped.
+bool pushSentenceQueue(SentenceQueue *queue, int device, const char *sentence, size_t length) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += SERIAL_ENQUEUE_TIMEOUT_MS * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == SENTENCE_QUEUE_CAPACITY) {
+        if (pthread_cond_timedwait(&queue->notFull, &queue->lock, &deadline) != 0) {
+            break;
+        }
+    }
+    if (queue->count == SENTENCE_QUEUE_CAPACITY) {
+        queue->dropped++;
+        pthread_mutex_unlock(&queue->lock);
+        return false;
+    }
+    int slot = (queue->head + queue->count) % SENTENCE_QUEUE_CAPACITY;
+    memcpy(queue->sentences[slot], sentence, length);
+    queue->sentences[slot][length] = '\0';
+    queue->devices[slot] = device;
+    queue->count++;
+    pthread_cond_signal(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+    return true;
+}
+
+bool popSentenceQueue(SentenceQueue *queue, int *device, char *sentence) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && !queue->closed) {
+        pthread_cond_wait(&queue->notEmpty, &queue->lock);
+    }
+    if (queue->count == 0) {
+        pthread_mutex_unlock(&queue->lock);
+        return false;
+    }
+    *device = queue->devices[queue->head];
+    strcpy(sentence, queue->sentences[queue->head]);
+    queue->head = (queue->head + 1) % SENTENCE_QUEUE_CAPACITY;
+    queue->count--;
+    pthread_cond_signal(&queue->notFull);
+    pthread_mutex_unlock(&queue->lock);
+    return true;
+}
+
+void closeSentenceQueue(SentenceQueue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+bool openSerialDevice(SerialDevice *device, const char *path) {
+    device->fd = open(path, O_RDONLY | O_NOCTTY | O_NONBLOCK);
+    if (device->fd < 0) {
+        printf("Error opening serial device %s.\n", path);
+        return false;
+    }
+    if (isatty(device->fd)) {
+        struct termios settings;
+        if (tcgetattr(device->fd, &settings) == 0) {
+            cfmakeraw(&settings);
+            tcsetattr(device->fd, TCSANOW, &settings);
+        }
+    }
+    snprintf(device->path, sizeof(device->path), "%s", path);
+    device->used = 0;
+    device->sentences = 0;
+    device->overlong = 0;
+    device->open = true;
+    return true;
+}
+
+// Appends one read() worth of bytes and hands every completed line to the queue. A line
+// longer than the device buffer is discarded up to its newline and counted.
+void consumeSerialBytes(SerialDevice *device, int index, const char *bytes, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        char c = bytes[i];
+        if (c == '\n' || c == '\r') {
+            if (device->used > 0 && device->used <= MAX_GPS_DATA_LEN - 1) {
+                if (pushSentenceQueue(&sentenceQueue, index, device->buffer, device->used)) {
+                    device->sentences++;
+                }
+            } else if (device->used > MAX_GPS_DATA_LEN - 1) {
+                device->overlong++;
+            }
+            device->used = 0;
+        } else if (c == '$') {
+            device->buffer[0] = c;
+            device->used = 1;
+        } else if (device->used < sizeof(device->buffer)) {
+            device->buffer[device->used++] = c;
+        } else {
+            device->used = sizeof(device->buffer) + 1;
+        }
     }
 }
 
+void *serialParserThread(void *arg) {
+    char sentence[MAX_GPS_DATA_LEN];
+    int device;
+    (void)arg;
+    while (popSentenceQueue(&sentenceQueue, &device, sentence)) {
+        printf("Received GPS Data from %s: %s\n", serialDevices[device].path, sentence);
+        processData(sentence);
+    }
+    return NULL;
+}
+
+// One epoll instance watches every device; the thread sleeps in epoll_wait until a
+// device has bytes, so an idle receiver costs no CPU. Returns when all devices hang up.
+void runSerialReader(int count) {
+    struct epoll_event events[MAX_SERIAL_DEVICES];
+    char chunk[SERIAL_READ_CHUNK];
+    pthread_t parser;
+    int remaining = 0;
+
+    int epollFd = epoll_create1(0);
+    if (epollFd < 0) {
+        printf("Error creating epoll instance.\n");
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!serialDevices[i].open) {
+            continue;
+        }
+        struct epoll_event interest;
+        interest.events = EPOLLIN | EPOLLRDHUP;
+        interest.data.u32 = (uint32_t)i;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, serialDevices[i].fd, &interest) == 0) {
+            remaining++;
+        }
+    }
+
+    initSentenceQueue(&sentenceQueue);
+    if (pthread_create(&parser, NULL, serialParserThread, NULL) != 0) {
+        printf("Error starting parser thread.\n");
+        close(epollFd);
+        return;
+    }
+
+    while (remaining > 0) {
+        int ready = epoll_wait(epollFd, events, MAX_SERIAL_DEVICES, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int e = 0; e < ready; e++) {
+            int index = (int)events[e].data.u32;
+            SerialDevice *device = &serialDevices[index];
+            ssize_t n;
+            while ((n = read(device->fd, chunk, sizeof(chunk))) > 0) {
+                consumeSerialBytes(device, index, chunk, (size_t)n);
+            }
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, device->fd, NULL);
+                close(device->fd);
+                device->open = false;
+                remaining--;
+            }
+        }
+    }
+
+    closeSentenceQueue(&sentenceQueue);
+    pthread_join(parser, NULL);
+    close(epollFd);
+
+    for (int i = 0; i < count; i++) {
+        printf("Device %s: %ld sentences, %ld overlong lines dropped\n",
+               serialDevices[i].path, serialDevices[i].sentences, serialDevices[i].overlong);
+    }
+    printf("Sentences dropped by back-pressure: %ld\n", sentenceQueue.dropped);
+}
+
+void runSerialDevices(int count, char **paths) {
+    int opened = 0;
+    for (int i = 0; i < count && opened < MAX_SERIAL_DEVICES; i++) {
+        if (openSerialDevice(&serialDevices[opened], paths[i])) {
+            opened++;
+        }
+    }
+    runSerialReader(opened);
+}
+
+// Stand-in for real receivers: writes the sample sentences into the master side of a
+// pseudo-terminal in uneven pieces, so the reader has to reassemble partial reads.
+void *ptyWriterThread(void *arg) {
+    int master = (int)(long)arg;
+    const char *sentences[] = {
+        "$GPGGA,123456.789,3751.65,S,14504.00,E,1,08,1.0,10.0,M,0.0,M,,*4F\r\n",
+        "$GPRMC,123456.789,A,3751.65,S,14504.00,E,1.0,10.0,190326,,,A*4A\r\n",
+        "$GPGGA,122233.789,3456.65,N,12345.00,E,1,08,1.0,20.0,M,0.0,M,,*54\r\n"
+    };
+    struct timespec pause = {0, 20000000L};
+
+    for (int i = 0; i < SERIAL_DEMO_SENTENCES; i++) {
+        const char *sentence = sentences[i % 3];
+        size_t length = strlen(sentence);
+        size_t split = (size_t)(rand() % (int)length);
+        if (write(master, sentence, split) < 0 || write(master, sentence + split, length - split) < 0) {
+            break;
+        }
+        nanosleep(&pause, NULL);
+    }
+    nanosleep(&pause, NULL);
+    close(master);
+    return NULL;
+}
+
+void runPseudoTerminalDemo(void) {
+    pthread_t writers[SERIAL_DEMO_DEVICES];
+    bool started[SERIAL_DEMO_DEVICES];
+    int count = 0;
+
+    for (int i = 0; i < SERIAL_DEMO_DEVICES; i++) {
+        started[i] = false;
+        int master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            printf("Error creating pseudo-terminal.\n");
+            if (master >= 0) {
+                close(master);
+            }
+            continue;
+        }
+        if (!openSerialDevice(&serialDevices[count], ptsname(master))) {
+            close(master);
+            continue;
+        }
+        started[count] = pthread_create(&writers[count], NULL, ptyWriterThread, (void *)(long)master) == 0;
+        count++;
+    }
+
+    runSerialReader(count);
+    for (int i = 0; i < count; i++) {
+        if (started[i]) {
+            pthread_join(writers[i], NULL);
+        }
+    }
+}
+#endif
+
 void processGPSData(GPS_Data *gps) {
     printGPSData(gps);
 }
@@ -156,16 +908,60 @@ void printGPSData(GPS_Data *gps) {
 }
 
 void processData(char *data) {
+    GPS_Data gps;
+    initGPSData(&gps);
 
+    if (parseNMEASentence(makeNMEASpan(data), &gps)) {
+        processGPSData(&gps);
+    } else {
+        printf("Invalid NMEA sentence.\n");
+    }
 }
 
 void initializeParser(void) {
     
 }
 
-bool validateChecksum(char *nmea) {
+// XOR of every byte between '$' and '*' must equal the two hex digits after '*'.
+// Whole 8-byte words are XORed together first and folded down to one byte at the end.
+bool validateChecksum(NMEASpan nmea) {
+    const char *star = memchr(nmea.data, '*', nmea.length);
+    if (star == NULL || (size_t)(star - nmea.data) + 3 > nmea.length) {
+        return false;
+    }
 
-    return true;
+    const char *p = nmea.data + 1;
+    size_t n = (size_t)(star - p);
+    uint64_t folded = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        folded ^= word;
+    }
+    unsigned char checksum = 0;
+    for (int b = 0; b < 8; b++) {
+        checksum ^= (unsigned char)(folded >> (8 * b));
+    }
+    for (; i < n; i++) {
+        checksum ^= (unsigned char)p[i];
+    }
+
+    unsigned int expected = 0;
+    for (int k = 1; k <= 2; k++) {
+        char c = star[k];
+        expected <<= 4;
+        if (c >= '0' && c <= '9') {
+            expected |= (unsigned int)(c - '0');
+        } else if (c >= 'A' && c <= 'F') {
+            expected |= (unsigned int)(c - 'A' + 10);
+        } else if (c >= 'a' && c <= 'f') {
+            expected |= (unsigned int)(c - 'a' + 10);
+        } else {
+            return false;
+        }
+    }
+    return checksum == expected;
 }
 
 void storeNMEASentence(char *sentence) {
@@ -179,13 +975,13 @@ void parseAdditionalFields(char *field_data, GPS_Data *gps) {
 
 void handleSerialInput2(void) {
     
-    strcpy(gps_data, "$GPRMC,123456.789,A,3751.65,S,14504.00,E,1.0,10.0,M,0.0,M,,*47");
+    strcpy(gps_data, "$GPRMC,123456.789,A,3751.65,S,14504.00,E,1.0,10.0,190326,,,A*4A");
     printf("Received GPS Data: %s\n", gps_data);
     
     GPS_Data gps;
     initGPSData(&gps);
 
-    if (parseNMEASentence(gps_data, &gps)) {
+    if (parseNMEASentence(makeNMEASpan(gps_data), &gps)) {
         processGPSData(&gps);
     } else {
         printf("Invalid NMEA sentence.\n");
@@ -246,13 +1042,13 @@ void printGPSData2(GPS_Data *gps) {
 
 void handleSerialInput3(void) {
     
-    strcpy(gps_data, "$GPGGA,122233.789,3456.65,N,12345.00,E,1,08,1.0,20.0,M,0.0,M,,*47");
+    strcpy(gps_data, "$GPGGA,122233.789,3456.65,N,12345.00,E,1,08,1.0,20.0,M,0.0,M,,*54");
     printf("Received GPS Data: %s\n", gps_data);
 
     GPS_Data gps;
     initGPSData(&gps);
 
-    if (parseNMEASentence(gps_data, &gps)) {
+    if (parseNMEASentence(makeNMEASpan(gps_data), &gps)) {
         processGPSData(&gps);
     } else {
         printf("Invalid NMEA sentence.\n");
@@ -1,6 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
 
 #define MAX_SAMPLES 1000
 #define SAMPLING_INTERVAL 1 
@@ -9,6 +15,22 @@
 #define ALERT_THRESHOLD 0.20 
 #define MOVING_AVERAGE_WINDOW 5 
 #define MULTI_SENSOR_COUNT 3 
+#define STA_LTA_CHANNELS (MULTI_SENSOR_COUNT + 1)
+#define STA_WINDOW 3
+#define LTA_WINDOW 20
+#define STA_LTA_ON_RATIO 2.5
+#define STA_LTA_OFF_RATIO 1.2
+#define STA_LTA_MIN_VOTES 2
+#define PRE_EVENT_PADDING 2
+#define POST_EVENT_PADDING 3
+#define MAX_TRACKED_CHANNELS 4096
+#define CHANNEL_RING_CAPACITY 32
+#define DEMO_CHANNELS 4
+#define CHECK_SAMPLES 200
+#define EVENT_QUEUE_CAPACITY 1024
+#define CACHE_LINE_SIZE 64
+#define DISPLAY_POINTS 20
+#define PYRAMID_LEVELS 11
 
 typedef struct {
     double timestamp;
@@ -17,19 +39,249 @@ typedef struct {
     double sensorData[MULTI_SENSOR_COUNT];
 } SeismicData;
 
+typedef struct {
+    double sta[STA_LTA_CHANNELS];
+    double lta[STA_LTA_CHANNELS];
+    int triggered[STA_LTA_CHANNELS];
+    int samplesSeen;
+    int postEventCountdown;
+    int nextIdx;
+} StaLtaTrigger;
+
+// Each channel owns its input: a ring of recent samples indexed by absolute sample
+// number. A sample stays until it is evaluated, plus PRE_EVENT_PADDING of history so
+// an event start can be backdated.
+typedef struct {
+    SeismicData *samples;
+    int written;
+} ChannelSampleRing;
+
+typedef struct {
+    StaLtaTrigger trigger;
+    ChannelSampleRing input;
+    int eventStartIdx;
+    int eventEndIdx;
+    int eventInProgress;
+    int completedEvents;
+    double eventStartTimestamp;
+    double peakDisplacement;
+} ChannelEventState;
+
+typedef struct {
+    int channel;
+    double startTimestamp;
+    double endTimestamp;
+    double peakDisplacement;
+} CompletedSeismicEvent;
+
+// Single-producer/single-consumer ring: the acquisition thread only writes tail,
+// the consumer thread only writes head, so neither side ever takes a lock.
+typedef struct {
+    CompletedSeismicEvent events[EVENT_QUEUE_CAPACITY];
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t head;
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t tail;
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t dropped;
+} CompletedEventQueue;
+
+typedef struct {
+    ChannelEventState *channels;
+    SeismicData *sampleStorage;
+    int numChannels;
+    CompletedEventQueue queue;
+    sem_t available;
+    atomic_int running;
+    pthread_t consumerThread;
+    atomic_int totalEvents;
+    double totalDuration;
+    double longestDuration;
+} EventTracker;
+
+typedef enum {
+    DECIMATE_MINMAX,
+    DECIMATE_LTTB
+} DecimationMode;
+
+typedef struct {
+    double timestamp;
+    double displacement;
+} DisplayPoint;
+
+// Level k holds min/max/sum over aligned blocks of 2^k samples; level 0 is the raw trace.
+typedef struct {
+    double min[PYRAMID_LEVELS][MAX_SAMPLES];
+    double max[PYRAMID_LEVELS][MAX_SAMPLES];
+    double sum[PYRAMID_LEVELS][MAX_SAMPLES];
+    int builtUpTo;
+} DisplacementPyramid;
+
 SeismicData seismicData[MAX_SAMPLES];
 int dataIndex = 0;
-int eventStartIdx = -1;
-int eventEndIdx = -1;
-int eventInProgress = 0;
-int totalSeismicEvents = 0;
+EventTracker eventTracker;
+DisplacementPyramid displacementPyramid;
 
 double generateSeismicReading() {
     return (rand() % 100) / 100.0; 
 }
 
-void initializeSeismicSystem() {
+void initializeStaLtaTrigger(StaLtaTrigger *trigger) {
+    for (int c = 0; c < STA_LTA_CHANNELS; c++) {
+        trigger->sta[c] = 0;
+        trigger->lta[c] = 0;
+        trigger->triggered[c] = 0;
+    }
+    trigger->samplesSeen = 0;
+    trigger->postEventCountdown = 0;
+    trigger->nextIdx = 0;
+}
+
+int publishCompletedEvent(CompletedEventQueue *queue, const CompletedSeismicEvent *event) {
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail - head == EVENT_QUEUE_CAPACITY) {
+        atomic_fetch_add_explicit(&queue->dropped, 1, memory_order_relaxed);
+        return 0;
+    }
+    queue->events[tail % EVENT_QUEUE_CAPACITY] = *event;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+int consumeCompletedEvent(CompletedEventQueue *queue, CompletedSeismicEvent *event) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head == tail) {
+        return 0;
+    }
+    *event = queue->events[head % EVENT_QUEUE_CAPACITY];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return 1;
+}
+
+void logCompletedEvent(const CompletedSeismicEvent *event) {
+    printf("Seismic event on channel %d ended at timestamp %.2f\n", event->channel, event->endTimestamp);
+    printf("Event duration: %.2f seconds\n", event->endTimestamp - event->startTimestamp);
+}
+
+void alertCompletedEvent(const CompletedSeismicEvent *event) {
+    if (event->peakDisplacement > ALERT_THRESHOLD) {
+        printf("ALERT: Seismic event on channel %d peaked at displacement %.2f\n",
+               event->channel, event->peakDisplacement);
+    }
+}
+
+void updateDurationStatistics(EventTracker *tracker, const CompletedSeismicEvent *event) {
+    double duration = event->endTimestamp - event->startTimestamp;
+    tracker->totalDuration += duration;
+    if (duration > tracker->longestDuration) {
+        tracker->longestDuration = duration;
+    }
+    atomic_fetch_add_explicit(&tracker->totalEvents, 1, memory_order_relaxed);
+}
+
+void dispatchCompletedEvent(EventTracker *tracker, const CompletedSeismicEvent *event) {
+    logCompletedEvent(event);
+    alertCompletedEvent(event);
+    updateDurationStatistics(tracker, event);
+}
+
+// The producer posts the semaphore once per published event and once more at shutdown,
+// so the consumer sleeps in sem_wait instead of polling, and an empty queue after a
+// wakeup can only mean shutdown.
+void *eventConsumerThread(void *arg) {
+    EventTracker *tracker = (EventTracker *)arg;
+    CompletedSeismicEvent event;
+
+    for (;;) {
+        while (sem_wait(&tracker->available) != 0 && errno == EINTR) {
+        }
+        if (consumeCompletedEvent(&tracker->queue, &event)) {
+            dispatchCompletedEvent(tracker, &event);
+        } else if (!atomic_load_explicit(&tracker->running, memory_order_acquire)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+int initializeEventTracker(EventTracker *tracker, int numChannels) {
+    tracker->channels = (ChannelEventState *)calloc(numChannels, sizeof(ChannelEventState));
+    tracker->sampleStorage = (SeismicData *)malloc((size_t)numChannels * CHANNEL_RING_CAPACITY * sizeof(SeismicData));
+    if (tracker->channels == NULL || tracker->sampleStorage == NULL) {
+        printf("Error allocating event tracker channels.\n");
+        free(tracker->channels);
+        free(tracker->sampleStorage);
+        tracker->channels = NULL;
+        tracker->sampleStorage = NULL;
+        return 0;
+    }
+    tracker->numChannels = numChannels;
+    for (int i = 0; i < numChannels; i++) {
+        initializeStaLtaTrigger(&tracker->channels[i].trigger);
+        tracker->channels[i].input.samples = tracker->sampleStorage + (size_t)i * CHANNEL_RING_CAPACITY;
+        tracker->channels[i].input.written = 0;
+        tracker->channels[i].eventStartIdx = -1;
+        tracker->channels[i].eventEndIdx = -1;
+        tracker->channels[i].eventInProgress = 0;
+    }
+    atomic_init(&tracker->queue.head, 0);
+    atomic_init(&tracker->queue.tail, 0);
+    atomic_init(&tracker->queue.dropped, 0);
+    atomic_init(&tracker->totalEvents, 0);
+    tracker->totalDuration = 0;
+    tracker->longestDuration = 0;
+    atomic_init(&tracker->running, 1);
+
+    if (sem_init(&tracker->available, 0, 0) != 0) {
+        printf("Error creating event queue semaphore.\n");
+        free(tracker->channels);
+        free(tracker->sampleStorage);
+        tracker->channels = NULL;
+        tracker->sampleStorage = NULL;
+        return 0;
+    }
+    if (pthread_create(&tracker->consumerThread, NULL, eventConsumerThread, tracker) != 0) {
+        printf("Error starting event consumer thread.\n");
+        sem_destroy(&tracker->available);
+        free(tracker->channels);
+        free(tracker->sampleStorage);
+        tracker->channels = NULL;
+        tracker->sampleStorage = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+void shutdownEventTracker(EventTracker *tracker) {
+    atomic_store_explicit(&tracker->running, 0, memory_order_release);
+    sem_post(&tracker->available);
+    pthread_join(tracker->consumerThread, NULL);
+    sem_destroy(&tracker->available);
+    free(tracker->channels);
+    free(tracker->sampleStorage);
+    tracker->channels = NULL;
+    tracker->sampleStorage = NULL;
+}
+
+const SeismicData *channelSample(const ChannelSampleRing *ring, int idx) {
+    return &ring->samples[idx % CHANNEL_RING_CAPACITY];
+}
+
+// Appends a sample to the channel's ring. Returns 0 when the channel has fallen too far
+// behind to make room without losing unevaluated samples or the pre-event history.
+int pushChannelSample(EventTracker *tracker, int channel, const SeismicData *sample) {
+    ChannelEventState *state = &tracker->channels[channel];
+    ChannelSampleRing *ring = &state->input;
+    if (ring->written - state->trigger.nextIdx >= CHANNEL_RING_CAPACITY - PRE_EVENT_PADDING) {
+        return 0;
+    }
+    ring->samples[ring->written % CHANNEL_RING_CAPACITY] = *sample;
+    ring->written++;
+    return 1;
+}
+
+int initializeSeismicSystem() {
     printf("Initializing seismic system...\n");
+    return initializeEventTracker(&eventTracker, MAX_TRACKED_CHANNELS);
 }
 
 void logSeismicEvent(double timestamp, double displacement, double acceleration) {
@@ -37,32 +289,73 @@ void logSeismicEvent(double timestamp, double displacement, double acceleration)
            timestamp, displacement, acceleration);
 }
 
-int isSeismicEventTriggered(double displacement) {
-    return displacement > SEISMIC_THRESHOLD;
+// Channel 0 is the displacement trace, the rest are the auxiliary sensor channels.
+void loadStaLtaChannels(const SeismicData *sample, double *channels) {
+    channels[0] = sample->displacement;
+    for (int i = 0; i < MULTI_SENSOR_COUNT; i++) {
+        channels[i + 1] = sample->sensorData[i];
+    }
 }
 
-void startEvent(int idx) {
-    if (!eventInProgress) {
-        eventStartIdx = idx;
-        eventInProgress = 1;
-        printf("Seismic event started at timestamp %.2f\n", seismicData[idx].timestamp);
+// Recursive STA/LTA update on signal energy, O(1) per sample and branch-free across
+// channels. The LTA is frozen while a channel is triggered so the event does not
+// raise its own background level. Returns 1 when enough channels agree.
+int isSeismicEventTriggered(StaLtaTrigger *trigger, const double *channels) {
+    int warmedUp = trigger->samplesSeen >= LTA_WINDOW;
+    int votes = 0;
+
+    for (int c = 0; c < STA_LTA_CHANNELS; c++) {
+        double energy = channels[c] * channels[c];
+        double lta = trigger->lta[c];
+        double sta = trigger->sta[c] + (energy - trigger->sta[c]) / STA_WINDOW;
+        double ratio = sta / (lta > 1e-12 ? lta : 1e-12);
+        int on = warmedUp & (ratio > STA_LTA_ON_RATIO);
+        int stillOn = warmedUp & (ratio > STA_LTA_OFF_RATIO);
+
+        trigger->triggered[c] = stillOn & (trigger->triggered[c] | on);
+        trigger->sta[c] = sta;
+        trigger->lta[c] += (1 - trigger->triggered[c]) * (energy - lta) / LTA_WINDOW;
+        votes += trigger->triggered[c];
     }
+
+    trigger->samplesSeen++;
+    return votes >= STA_LTA_MIN_VOTES;
 }
 
-void endEvent(int idx) {
-    if (eventInProgress) {
-        eventEndIdx = idx;
-        eventInProgress = 0;
-        double duration = seismicData[eventEndIdx].timestamp - seismicData[eventStartIdx].timestamp;
-        printf("Seismic event ended at timestamp %.2f\n", seismicData[idx].timestamp);
-        printf("Event duration: %.2f seconds\n", duration);
-        totalSeismicEvents++;
+void startEvent(EventTracker *tracker, int channel, int idx) {
+    ChannelEventState *state = &tracker->channels[channel];
+    if (!state->eventInProgress) {
+        state->eventStartIdx = idx;
+        state->eventStartTimestamp = channelSample(&state->input, idx)->timestamp;
+        state->eventInProgress = 1;
+        state->peakDisplacement = 0;
+        printf("Seismic event on channel %d started at timestamp %.2f\n", channel, state->eventStartTimestamp);
     }
 }
 
-void triggerAlert(double displacement) {
+void endEvent(EventTracker *tracker, int channel, int idx) {
+    ChannelEventState *state = &tracker->channels[channel];
+    if (state->eventInProgress) {
+        state->eventEndIdx = idx;
+        state->eventInProgress = 0;
+        state->completedEvents++;
+
+        CompletedSeismicEvent event;
+        event.channel = channel;
+        event.startTimestamp = state->eventStartTimestamp;
+        event.endTimestamp = channelSample(&state->input, idx)->timestamp;
+        event.peakDisplacement = state->peakDisplacement;
+        if (publishCompletedEvent(&tracker->queue, &event)) {
+            sem_post(&tracker->available);
+        } else {
+            printf("Event queue full, dropped event on channel %d.\n", channel);
+        }
+    }
+}
+
+void triggerAlert(int channel, double displacement) {
     if (displacement > ALERT_THRESHOLD) {
-        printf("ALERT: Significant seismic activity detected! Displacement: %.2f\n", displacement);
+        printf("ALERT: Significant seismic activity detected on channel %d! Displacement: %.2f\n", channel, displacement);
     }
 }
 
@@ -78,6 +371,28 @@ double calculateMovingAverage(int windowSize) {
     return (count > 0) ? sum / count : 0;
 }
 
+void evaluateSeismicEventDuration(EventTracker *tracker, int channel);
+
+// Hands a sample to a channel, evaluating the channel first if its ring is full.
+void feedChannel(EventTracker *tracker, int channel, const SeismicData *sample) {
+    if (!pushChannelSample(tracker, channel, sample)) {
+        evaluateSeismicEventDuration(tracker, channel);
+        pushChannelSample(tracker, channel, sample);
+    }
+}
+
+// Synthetic stream for the extra demo channels and the isolation check: low background
+// noise with a short burst on every component starting at burstStart.
+void generateChannelSample(int burstStart, int idx, unsigned int *seed, SeismicData *sample) {
+    double amplitude = (idx >= burstStart && idx < burstStart + 4) ? 0.4 : 0.1;
+    sample->timestamp = idx * SAMPLING_INTERVAL;
+    sample->displacement = amplitude * (rand_r(seed) % 100) / 100.0;
+    sample->acceleration = amplitude * (rand_r(seed) % 100) / 100.0;
+    for (int i = 0; i < MULTI_SENSOR_COUNT; i++) {
+        sample->sensorData[i] = amplitude * (rand_r(seed) % 100) / 100.0;
+    }
+}
+
 void recordSeismicData() {
     if (dataIndex < MAX_SAMPLES) {
         double displacement = generateSeismicReading();
@@ -94,6 +409,7 @@ void recordSeismicData() {
         }
 
         logSeismicEvent(timestamp, displacement, acceleration);
+        feedChannel(&eventTracker, 0, &seismicData[dataIndex]);
 
         dataIndex++;
     } else {
@@ -101,22 +417,49 @@ void recordSeismicData() {
     }
 }
 
-void evaluateSeismicEventDuration() {
-    for (int i = 0; i < dataIndex; i++) {
-        double displacement = seismicData[i].displacement;
+// Channels 1..DEMO_CHANNELS-1 stand in for other stations, each with its own stream and
+// a burst at a different time. Channel 0 is the recorded trace.
+void recordDemoChannels(int idx) {
+    static unsigned int seeds[DEMO_CHANNELS];
+    SeismicData sample;
+    for (int channel = 1; channel < DEMO_CHANNELS; channel++) {
+        if (idx == 0) {
+            seeds[channel] = (unsigned int)channel * 7919u;
+        }
+        generateChannelSample(20 + 2 * channel, idx, &seeds[channel], &sample);
+        feedChannel(&eventTracker, channel, &sample);
+    }
+}
+
+void evaluateSeismicEventDuration(EventTracker *tracker, int channel) {
+    ChannelEventState *state = &tracker->channels[channel];
+    StaLtaTrigger *trigger = &state->trigger;
+    double channels[STA_LTA_CHANNELS];
+
+    for (int i = trigger->nextIdx; i < state->input.written; i++) {
+        const SeismicData *sample = channelSample(&state->input, i);
+        double displacement = sample->displacement;
+        loadStaLtaChannels(sample, channels);
 
-        if (isSeismicEventTriggered(displacement)) {
-            if (!eventInProgress) {
-                startEvent(i);
+        if (isSeismicEventTriggered(trigger, channels)) {
+            trigger->postEventCountdown = POST_EVENT_PADDING;
+            if (!state->eventInProgress) {
+                startEvent(tracker, channel, i >= PRE_EVENT_PADDING ? i - PRE_EVENT_PADDING : 0);
             }
-        } else {
-            if (eventInProgress && (i - eventStartIdx >= EVENT_DURATION_THRESHOLD)) {
-                endEvent(i);
+        } else if (state->eventInProgress) {
+            if (trigger->postEventCountdown > 0) {
+                trigger->postEventCountdown--;
+            } else if (i - state->eventStartIdx >= EVENT_DURATION_THRESHOLD) {
+                endEvent(tracker, channel, i);
             }
         }
 
-        triggerAlert(displacement);
+        if (state->eventInProgress && displacement > state->peakDisplacement) {
+            state->peakDisplacement = displacement;
+        }
+        triggerAlert(channel, displacement);
     }
+    trigger->nextIdx = state->input.written;
 }
 
 void saveSeismicDataToFile() {
@@ -133,7 +476,8 @@ void saveSeismicDataToFile() {
 }
 
 void calculateSeismicEventFrequency() {
-    printf("Total seismic events detected: %d\n", totalSeismicEvents);
+    printf("Total seismic events detected: %d\n",
+           atomic_load_explicit(&eventTracker.totalEvents, memory_order_relaxed));
 }
 
 void estimateEventSeverity(double displacement) {
@@ -144,17 +488,184 @@ void estimateEventSeverity(double displacement) {
     }
 }
 
-void generateSimulatedGraph() {
-    
-    printf("Generating simulated graph of seismic displacement...\n");
-    for (int i = 0; i < dataIndex; i++) {
-        printf("Time: %.2f, Displacement: %.2f\n", seismicData[i].timestamp, seismicData[i].displacement);
+// Extends the pyramid with samples recorded since the last call, O(levels) per sample.
+void updateDisplacementPyramid(DisplacementPyramid *pyramid) {
+    for (int i = pyramid->builtUpTo; i < dataIndex; i++) {
+        double value = seismicData[i].displacement;
+        pyramid->min[0][i] = value;
+        pyramid->max[0][i] = value;
+        pyramid->sum[0][i] = value;
+
+        for (int k = 1; k < PYRAMID_LEVELS; k++) {
+            int j = i >> k;
+            int left = 2 * j;
+            int right = left + 1;
+            pyramid->min[k][j] = pyramid->min[k - 1][left];
+            pyramid->max[k][j] = pyramid->max[k - 1][left];
+            pyramid->sum[k][j] = pyramid->sum[k - 1][left];
+            if ((right << (k - 1)) <= i) {
+                pyramid->min[k][j] = fmin(pyramid->min[k][j], pyramid->min[k - 1][right]);
+                pyramid->max[k][j] = fmax(pyramid->max[k][j], pyramid->max[k - 1][right]);
+                pyramid->sum[k][j] += pyramid->sum[k - 1][right];
+            }
+        }
+    }
+    pyramid->builtUpTo = dataIndex;
+}
+
+// Min/max/sum over samples [from, to) by covering the range with the largest aligned
+// pyramid blocks, so the cost is O(log n) regardless of the range length.
+void queryDisplacementRange(DisplacementPyramid *pyramid, int from, int to,
+                            double *minValue, double *maxValue, double *sum) {
+    *minValue = INFINITY;
+    *maxValue = -INFINITY;
+    *sum = 0;
+    while (from < to) {
+        int k = 0;
+        while (k + 1 < PYRAMID_LEVELS && (from & ((1 << (k + 1)) - 1)) == 0 && from + (1 << (k + 1)) <= to) {
+            k++;
+        }
+        int j = from >> k;
+        *minValue = fmin(*minValue, pyramid->min[k][j]);
+        *maxValue = fmax(*maxValue, pyramid->max[k][j]);
+        *sum += pyramid->sum[k][j];
+        from += 1 << k;
+    }
+}
+
+int decimateMinMax(DisplacementPyramid *pyramid, int from, int to, int points, DisplayPoint *out) {
+    int buckets = points / 2;
+    int span = to - from;
+    int count = 0;
+    if (buckets < 1 || span <= 0) {
+        return 0;
+    }
+    if (span < buckets) {
+        buckets = span;
+    }
+
+    for (int b = 0; b < buckets; b++) {
+        int start = from + (int)((long)span * b / buckets);
+        int end = from + (int)((long)span * (b + 1) / buckets);
+        double minValue, maxValue, sum;
+        queryDisplacementRange(pyramid, start, end, &minValue, &maxValue, &sum);
+
+        double timestamp = (seismicData[start].timestamp + seismicData[end - 1].timestamp) / 2;
+        out[count].timestamp = timestamp;
+        out[count].displacement = minValue;
+        count++;
+        out[count].timestamp = timestamp;
+        out[count].displacement = maxValue;
+        count++;
+    }
+    return count;
+}
+
+// Largest-triangle-three-buckets over block means taken from the coarsest pyramid level
+// that still leaves a few candidates per output bucket.
+int decimateLTTB(DisplacementPyramid *pyramid, int from, int to, int points, DisplayPoint *out) {
+    static DisplayPoint series[MAX_SAMPLES];
+    int span = to - from;
+    int k = 0;
+    int n = 0;
+    if (points < 3 || span <= 0) {
+        return 0;
+    }
+    while (k + 1 < PYRAMID_LEVELS && (span >> (k + 1)) >= points * 4) {
+        k++;
+    }
+
+    for (int j = from >> k; (j << k) < to; j++) {
+        int start = (j << k) > from ? (j << k) : from;
+        int end = ((j + 1) << k) < to ? ((j + 1) << k) : to;
+        double minValue, maxValue, sum;
+        queryDisplacementRange(pyramid, start, end, &minValue, &maxValue, &sum);
+        series[n].timestamp = (seismicData[start].timestamp + seismicData[end - 1].timestamp) / 2;
+        series[n].displacement = sum / (end - start);
+        n++;
+    }
+
+    if (n <= points) {
+        for (int i = 0; i < n; i++) {
+            out[i] = series[i];
+        }
+        return n;
+    }
+
+    double bucketSize = (double)(n - 2) / (points - 2);
+    int selected = 0;
+    int count = 0;
+    out[count++] = series[0];
+
+    for (int b = 0; b < points - 2; b++) {
+        int start = (int)(b * bucketSize) + 1;
+        int end = (int)((b + 1) * bucketSize) + 1;
+        int nextStart = end;
+        int nextEnd = (int)((b + 2) * bucketSize) + 1;
+        if (nextEnd > n) {
+            nextEnd = n;
+        }
+
+        double avgTime = 0, avgValue = 0;
+        for (int i = nextStart; i < nextEnd; i++) {
+            avgTime += series[i].timestamp;
+            avgValue += series[i].displacement;
+        }
+        avgTime /= nextEnd - nextStart;
+        avgValue /= nextEnd - nextStart;
+
+        double bestArea = -1;
+        int best = start;
+        for (int i = start; i < end; i++) {
+            double area = fabs((series[selected].timestamp - avgTime) * (series[i].displacement - series[selected].displacement) -
+                               (series[selected].timestamp - series[i].timestamp) * (avgValue - series[selected].displacement));
+            if (area > bestArea) {
+                bestArea = area;
+                best = i;
+            }
+        }
+        out[count++] = series[best];
+        selected = best;
+    }
+
+    out[count++] = series[n - 1];
+    return count;
+}
+
+void generateZoomedGraph(int from, int to, DecimationMode mode) {
+    DisplayPoint points[DISPLAY_POINTS];
+    int count;
+
+    updateDisplacementPyramid(&displacementPyramid);
+    if (from < 0) {
+        from = 0;
+    }
+    if (to > dataIndex) {
+        to = dataIndex;
     }
+
+    if (mode == DECIMATE_LTTB) {
+        count = decimateLTTB(&displacementPyramid, from, to, DISPLAY_POINTS, points);
+    } else {
+        count = decimateMinMax(&displacementPyramid, from, to, DISPLAY_POINTS, points);
+    }
+
+    for (int i = 0; i < count; i++) {
+        printf("Time: %.2f, Displacement: %.2f\n", points[i].timestamp, points[i].displacement);
+    }
+}
+
+void generateSimulatedGraph(DecimationMode mode) {
+    printf("Generating simulated graph of seismic displacement (%s, %d points)...\n",
+           mode == DECIMATE_LTTB ? "LTTB" : "min/max", DISPLAY_POINTS);
+    generateZoomedGraph(0, dataIndex, mode);
 }
 
 void processSeismicData() {
     printf("Processing seismic data...\n");
-    evaluateSeismicEventDuration();
+    for (int channel = 0; channel < DEMO_CHANNELS; channel++) {
+        evaluateSeismicEventDuration(&eventTracker, channel);
+    }
     calculateSeismicEventFrequency();
 }
 
@@ -163,6 +674,7 @@ void monitorSeismicActivity() {
 
     for (int i = 0; i < 50; i++) {
         recordSeismicData();
+        recordDemoChannels(i);
 
         if (i % 10 == 0) {
             processSeismicData();
@@ -180,14 +692,87 @@ void monitorSeismicActivity() {
         estimateEventSeverity(seismicData[dataIndex-1].displacement);
     }
 
-    generateSimulatedGraph();
+    processSeismicData();
+    generateSimulatedGraph(DECIMATE_MINMAX);
+    generateSimulatedGraph(DECIMATE_LTTB);
     printf("Seismic monitoring completed.\n");
 }
 
-int main() {
-    initializeSeismicSystem();
+int sameChannelState(const ChannelEventState *a, const ChannelEventState *b) {
+    return memcmp(&a->trigger, &b->trigger, sizeof(a->trigger)) == 0 &&
+           a->input.written == b->input.written &&
+           a->eventStartIdx == b->eventStartIdx &&
+           a->eventEndIdx == b->eventEndIdx &&
+           a->eventInProgress == b->eventInProgress &&
+           a->completedEvents == b->completedEvents &&
+           a->eventStartTimestamp == b->eventStartTimestamp &&
+           a->peakDisplacement == b->peakDisplacement;
+}
+
+// Runs one stream on a channel by itself, then the same stream on channel 1 of a tracker
+// whose neighbours carry their own bursts and are evaluated on other cadences. The
+// channel's trigger and event state must come out bit-for-bit the same.
+int checkChannelIsolation(void) {
+    EventTracker alone, shared;
+    SeismicData sample;
+    unsigned int aloneSeed = 22;
+    unsigned int seeds[3] = {11, 22, 33};
+    int bursts[3] = {25, 60, 40};
+    int passed;
+
+    if (!initializeEventTracker(&alone, 1)) {
+        return 0;
+    }
+    if (!initializeEventTracker(&shared, 3)) {
+        shutdownEventTracker(&alone);
+        return 0;
+    }
+    for (int i = 0; i < CHECK_SAMPLES; i++) {
+        generateChannelSample(bursts[1], i, &aloneSeed, &sample);
+        feedChannel(&alone, 0, &sample);
+        if (i % 7 == 6) {
+            evaluateSeismicEventDuration(&alone, 0);
+        }
+        for (int channel = 0; channel < 3; channel++) {
+            generateChannelSample(bursts[channel], i, &seeds[channel], &sample);
+            feedChannel(&shared, channel, &sample);
+            if (i % (channel + 3) == 0) {
+                evaluateSeismicEventDuration(&shared, channel);
+            }
+        }
+    }
+    evaluateSeismicEventDuration(&alone, 0);
+    for (int channel = 0; channel < 3; channel++) {
+        evaluateSeismicEventDuration(&shared, channel);
+    }
+
+    passed = alone.channels[0].completedEvents > 0 &&
+             shared.channels[0].completedEvents > 0 &&
+             shared.channels[2].completedEvents > 0 &&
+             sameChannelState(&alone.channels[0], &shared.channels[1]);
+    shutdownEventTracker(&alone);
+    shutdownEventTracker(&shared);
+    printf("Channel isolation check: %s\n", passed ? "passed" : "FAILED");
+    return passed;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--check-channels") == 0) {
+        return checkChannelIsolation() ? 0 : 1;
+    }
+    if (!initializeSeismicSystem()) {
+        return 1;
+    }
 
     monitorSeismicActivity();
 
+    shutdownEventTracker(&eventTracker);
+    calculateSeismicEventFrequency();
+    if (atomic_load(&eventTracker.totalEvents) > 0) {
+        printf("Average event duration: %.2f seconds, longest: %.2f seconds\n",
+               eventTracker.totalDuration / atomic_load(&eventTracker.totalEvents), eventTracker.longestDuration);
+    }
+    printf("Dropped events: %zu\n", atomic_load(&eventTracker.queue.dropped));
+
     return 0;
 }
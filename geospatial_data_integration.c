@@ -1,8 +1,23 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 #define EARTH_RADIUS 6371.0 
+#define SPATIAL_MAX_LEVELS 30
+#define CATALOG_BLOCK 256
+#define CATALOG_MAX_COLUMNS 16
+#define CATALOG_PATH_LEN 1024
+#define CATALOG_CACHE_MAGIC "GEOCAT1"
+#define CATALOG_CACHE_SUFFIX ".cache"
 
 typedef struct {
     double latitude;
@@ -10,6 +25,69 @@ typedef struct {
     char name[50];
 } GeoLocation;
 
+typedef struct {
+    double coordinates[3];
+    int location;
+} SpatialPoint;
+
+// Storage follows the logarithmic method: level i is either empty or a balanced k-d tree
+// of exactly 2^i points at offset 2^i - 1, and bit i of count says which. Queries visit
+// every occupied level with a shared candidate set, so pruning carries across levels.
+typedef struct {
+    SpatialPoint *points;
+    unsigned char *axes;
+    int count;
+    int capacity;
+} SpatialIndex;
+
+typedef struct {
+    int index;
+    double distance;
+} LocationDistance;
+
+// Structure-of-arrays copy of a location list for batched distance scans. Each entry is
+// the unit vector of its latitude/longitude, so the per-entry trig is paid once at build.
+typedef struct {
+    double *x;
+    double *y;
+    double *z;
+    int count;
+} LocationCatalog;
+
+// On-disk cache layout: this header, then latitude[], longitude[], x[], y[], z[] as doubles,
+// nameOffsets[] as int32 and the NUL-separated name pool. Native byte order; the cache is
+// a local artefact, never exchanged between machines.
+typedef struct {
+    char magic[8];
+    int64_t sourceSize;
+    int64_t sourceModified;
+    int32_t count;
+    int32_t namesBytes;
+} CatalogCacheHeader;
+
+// A loaded site catalog. All arrays point into the mapped cache file.
+typedef struct {
+    const double *latitude;
+    const double *longitude;
+    LocationCatalog vectors;
+    const int32_t *nameOffsets;
+    const char *names;
+    int count;
+    void *mapping;
+    size_t mappingSize;
+} StationCatalog;
+
+typedef struct {
+    double *latitude;
+    double *longitude;
+    int32_t *nameOffsets;
+    char *names;
+    int count;
+    int capacity;
+    size_t namesBytes;
+    size_t namesCapacity;
+} CatalogBuilder;
+
 
 double haversine(double lat1, double lon1, double lat2, double lon2) {
     double lat1Rad = lat1 * M_PI / 180.0;
@@ -30,6 +108,445 @@ double haversine(double lat1, double lon1, double lat2, double lon2) {
 }
 
 
+// Locations are indexed as unit vectors on the sphere: great-circle order equals chord
+// order there, so a plain 3D k-d tree answers nearest and radius queries.
+void toUnitVector(double latitude, double longitude, double *coordinates) {
+    double latRad = latitude * M_PI / 180.0;
+    double lonRad = longitude * M_PI / 180.0;
+    coordinates[0] = cos(latRad) * cos(lonRad);
+    coordinates[1] = cos(latRad) * sin(lonRad);
+    coordinates[2] = sin(latRad);
+}
+
+double squaredChord(const double *a, const double *b) {
+    double dx = a[0] - b[0];
+    double dy = a[1] - b[1];
+    double dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+double chordToKilometers(double chordSquared) {
+    double halfChord = sqrt(chordSquared) / 2;
+    return 2 * EARTH_RADIUS * asin(halfChord > 1 ? 1 : halfChord);
+}
+
+int buildLocationCatalog(LocationCatalog *catalog, const GeoLocation *locations, int numLocations) {
+    catalog->x = (double *)malloc(3 * (numLocations + 1) * sizeof(double));
+    if (catalog->x == NULL) {
+        catalog->count = 0;
+        return 0;
+    }
+    catalog->y = catalog->x + numLocations + 1;
+    catalog->z = catalog->y + numLocations + 1;
+    for (int i = 0; i < numLocations; i++) {
+        double coordinates[3];
+        toUnitVector(locations[i].latitude, locations[i].longitude, coordinates);
+        catalog->x[i] = coordinates[0];
+        catalog->y[i] = coordinates[1];
+        catalog->z[i] = coordinates[2];
+    }
+    catalog->count = numLocations;
+    return 1;
+}
+
+void freeLocationCatalog(LocationCatalog *catalog) {
+    free(catalog->x);
+    catalog->x = catalog->y = catalog->z = NULL;
+    catalog->count = 0;
+}
+
+// Central angle from the haversine term a = sin^2(c/2) = chord^2 / 4, as
+// c = 2 atan2(sqrt(a), sqrt(1 - a)). The ratio is folded into [0, 1] and then about
+// tan(pi/8), leaving |y| <= 0.4143 for a 12-term atan series. The series alternates, so
+// the truncation error is below 0.4143^25 / 25 < 1.1e-11 rad (< 0.15 mm on the Earth);
+// everything else is plain rounding. Branch-free so the callers' loops vectorize.
+double approximateCentralAngle(double a) {
+    a = a < 0 ? 0 : (a > 1 ? 1 : a);
+    double s = sqrt(a), t = sqrt(1 - a);
+    int swapped = s > t;
+    double x = swapped ? t / s : s / t;
+    int shifted = x > 0.41421356237309503;
+    double y = shifted ? (x - 1) / (x + 1) : x;
+    double y2 = y * y;
+
+    double p = -1.0 / 23;
+    p = p * y2 + 1.0 / 21;
+    p = p * y2 - 1.0 / 19;
+    p = p * y2 + 1.0 / 17;
+    p = p * y2 - 1.0 / 15;
+    p = p * y2 + 1.0 / 13;
+    p = p * y2 - 1.0 / 11;
+    p = p * y2 + 1.0 / 9;
+    p = p * y2 - 1.0 / 7;
+    p = p * y2 + 1.0 / 5;
+    p = p * y2 - 1.0 / 3;
+    p = p * y2 + 1.0;
+
+    double angle = y * p + (shifted ? M_PI / 4 : 0);
+    angle = swapped ? M_PI / 2 - angle : angle;
+    return 2 * angle;
+}
+
+// Distances in km from one point to every catalog entry. No trigonometry per entry: the
+// catalog holds unit vectors, so the haversine term is a squared difference. Compile with
+// -O3 (or -O2 -ftree-vectorize) to get the SIMD version of this loop.
+void batchHaversine(const LocationCatalog *catalog, double latitude, double longitude, double *restrict distances) {
+    const double *restrict x = catalog->x;
+    const double *restrict y = catalog->y;
+    const double *restrict z = catalog->z;
+    double query[3];
+    toUnitVector(latitude, longitude, query);
+
+    for (int i = 0; i < catalog->count; i++) {
+        double dx = x[i] - query[0];
+        double dy = y[i] - query[1];
+        double dz = z[i] - query[2];
+        distances[i] = EARTH_RADIUS * approximateCentralAngle((dx * dx + dy * dy + dz * dz) * 0.25);
+    }
+}
+
+void computeSquaredChords(const LocationCatalog *catalog, int start, int count, const double *query, double *restrict chords) {
+    const double *restrict x = catalog->x + start;
+    const double *restrict y = catalog->y + start;
+    const double *restrict z = catalog->z + start;
+    for (int i = 0; i < count; i++) {
+        double dx = x[i] - query[0];
+        double dy = y[i] - query[1];
+        double dz = z[i] - query[2];
+        chords[i] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+// Radius scan over the catalog: the filter compares squared chords, which is exact, and
+// only the matches pay for the angle. Same contract as findLocationIndicesInRadius.
+int scanCatalogRadius(const LocationCatalog *catalog, double latitude, double longitude, double radius,
+                      LocationDistance *matches, int maxMatches) {
+    double chords[CATALOG_BLOCK];
+    double query[3];
+    double angle = radius / EARTH_RADIUS;
+    double limit = 2 * sin((angle < M_PI ? angle : M_PI) / 2);
+    int found = 0;
+    limit *= limit;
+    toUnitVector(latitude, longitude, query);
+
+    for (int start = 0; start < catalog->count; start += CATALOG_BLOCK) {
+        int count = catalog->count - start < CATALOG_BLOCK ? catalog->count - start : CATALOG_BLOCK;
+        computeSquaredChords(catalog, start, count, query, chords);
+        for (int i = 0; i < count; i++) {
+            if (chords[i] <= limit) {
+                if (found < maxMatches) {
+                    matches[found].index = start + i;
+                    matches[found].distance = EARTH_RADIUS * approximateCentralAngle(chords[i] * 0.25);
+                }
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+int findNearestInCatalog(const LocationCatalog *catalog, double latitude, double longitude, LocationDistance *nearest) {
+    double chords[CATALOG_BLOCK];
+    double query[3];
+    double best = 5;
+    int bestIndex = -1;
+    toUnitVector(latitude, longitude, query);
+
+    for (int start = 0; start < catalog->count; start += CATALOG_BLOCK) {
+        int count = catalog->count - start < CATALOG_BLOCK ? catalog->count - start : CATALOG_BLOCK;
+        computeSquaredChords(catalog, start, count, query, chords);
+        for (int i = 0; i < count; i++) {
+            if (chords[i] < best) {
+                best = chords[i];
+                bestIndex = start + i;
+            }
+        }
+    }
+    if (bestIndex < 0) {
+        return 0;
+    }
+    nearest->index = bestIndex;
+    nearest->distance = EARTH_RADIUS * approximateCentralAngle(best * 0.25);
+    return 1;
+}
+
+void initializeSpatialIndex(SpatialIndex *index) {
+    index->points = NULL;
+    index->axes = NULL;
+    index->count = 0;
+    index->capacity = 0;
+}
+
+void freeSpatialIndex(SpatialIndex *index) {
+    free(index->points);
+    free(index->axes);
+    initializeSpatialIndex(index);
+}
+
+int reserveSpatialIndex(SpatialIndex *index, int needed) {
+    if (needed <= index->capacity) {
+        return 1;
+    }
+    int capacity = index->capacity ? index->capacity : 15;
+    while (capacity < needed) {
+        capacity = capacity * 2 + 1;
+    }
+    SpatialPoint *points = (SpatialPoint *)realloc(index->points, capacity * sizeof(SpatialPoint));
+    if (points == NULL) {
+        return 0;
+    }
+    index->points = points;
+    unsigned char *axes = (unsigned char *)realloc(index->axes, capacity);
+    if (axes == NULL) {
+        return 0;
+    }
+    index->axes = axes;
+    index->capacity = capacity;
+    return 1;
+}
+
+// Quickselect on one coordinate so points[nth] is the median of [lo, hi).
+void selectByAxis(SpatialPoint *points, int lo, int hi, int nth, int axis) {
+    hi--;
+    while (lo < hi) {
+        double pivot = points[lo + (hi - lo) / 2].coordinates[axis];
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (points[i].coordinates[axis] < pivot) i++;
+            while (points[j].coordinates[axis] > pivot) j--;
+            if (i <= j) {
+                SpatialPoint temp = points[i];
+                points[i] = points[j];
+                points[j] = temp;
+                i++;
+                j--;
+            }
+        }
+        if (nth <= j) {
+            hi = j;
+        } else if (nth >= i) {
+            lo = i;
+        } else {
+            return;
+        }
+    }
+}
+
+// Implicit tree: the node of [lo, hi) sits at the midpoint and splits on the axis of
+// widest spread, so no child pointers are stored.
+void buildSpatialTree(SpatialIndex *index, int lo, int hi) {
+    while (hi - lo > 1) {
+        double minimum[3] = {2, 2, 2}, maximum[3] = {-2, -2, -2};
+        for (int i = lo; i < hi; i++) {
+            for (int a = 0; a < 3; a++) {
+                double value = index->points[i].coordinates[a];
+                if (value < minimum[a]) minimum[a] = value;
+                if (value > maximum[a]) maximum[a] = value;
+            }
+        }
+        int axis = 0;
+        for (int a = 1; a < 3; a++) {
+            if (maximum[a] - minimum[a] > maximum[axis] - minimum[axis]) {
+                axis = a;
+            }
+        }
+        int mid = lo + (hi - lo) / 2;
+        selectByAxis(index->points, lo, hi, mid, axis);
+        index->axes[mid] = (unsigned char)axis;
+        buildSpatialTree(index, lo, mid);
+        lo = mid + 1;
+    }
+    if (hi - lo == 1) {
+        index->axes[lo] = 0;
+    }
+}
+
+// Bulk build. Levels follow the binary digits of the count; see SpatialIndex.
+int buildSpatialIndex(SpatialIndex *index, const GeoLocation *locations, int numLocations) {
+    index->count = 0;
+    if (!reserveSpatialIndex(index, 2 * numLocations + 1)) {
+        return 0;
+    }
+    int next = 0;
+    for (int level = 0; level < SPATIAL_MAX_LEVELS; level++) {
+        int size = 1 << level;
+        if (!(numLocations & size)) {
+            continue;
+        }
+        int offset = size - 1;
+        for (int i = 0; i < size; i++, next++) {
+            toUnitVector(locations[next].latitude, locations[next].longitude, index->points[offset + i].coordinates);
+            index->points[offset + i].location = next;
+        }
+        buildSpatialTree(index, offset, offset + size);
+    }
+    index->count = numLocations;
+    return 1;
+}
+
+// Logarithmic-method insert: the full levels below the first empty one are contiguous,
+// so they move up in one copy and are rebuilt together with the new point.
+int insertSpatialIndex(SpatialIndex *index, const GeoLocation *location, int locationIndex) {
+    int level = 0;
+    while (index->count & (1 << level)) {
+        level++;
+    }
+    if (level >= SPATIAL_MAX_LEVELS) {
+        return 0;
+    }
+    int size = 1 << level;
+    if (!reserveSpatialIndex(index, 2 * size - 1)) {
+        return 0;
+    }
+    SpatialPoint *target = &index->points[size - 1];
+    memcpy(target, index->points, (size - 1) * sizeof(SpatialPoint));
+    toUnitVector(location->latitude, location->longitude, target[size - 1].coordinates);
+    target[size - 1].location = locationIndex;
+    buildSpatialTree(index, size - 1, 2 * size - 1);
+    index->count++;
+    return 1;
+}
+
+// Max-heap on distance, so the worst of the current k candidates is at the top.
+void siftDistanceHeapDown(LocationDistance *heap, int size, int i) {
+    for (;;) {
+        int largest = i;
+        int left = 2 * i + 1, right = 2 * i + 2;
+        if (left < size && heap[left].distance > heap[largest].distance) largest = left;
+        if (right < size && heap[right].distance > heap[largest].distance) largest = right;
+        if (largest == i) {
+            return;
+        }
+        LocationDistance temp = heap[i];
+        heap[i] = heap[largest];
+        heap[largest] = temp;
+        i = largest;
+    }
+}
+
+void pushDistanceHeap(LocationDistance *heap, int *size, LocationDistance item) {
+    int i = (*size)++;
+    while (i > 0 && heap[(i - 1) / 2].distance < item.distance) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = item;
+}
+
+void offerDistanceHeap(LocationDistance *heap, int *size, int k, LocationDistance item) {
+    if (*size < k) {
+        pushDistanceHeap(heap, size, item);
+    } else if (item.distance < heap[0].distance) {
+        heap[0] = item;
+        siftDistanceHeapDown(heap, *size, 0);
+    }
+}
+
+// Pops the heap into ascending order in place.
+void sortDistanceHeap(LocationDistance *heap, int size) {
+    for (int end = size - 1; end > 0; end--) {
+        LocationDistance top = heap[0];
+        heap[0] = heap[end];
+        heap[end] = top;
+        siftDistanceHeapDown(heap, end, 0);
+    }
+}
+
+void searchNearest(const SpatialIndex *index, int lo, int hi, const double *query,
+                   LocationDistance *heap, int *heapSize, int k) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        const SpatialPoint *point = &index->points[mid];
+        LocationDistance candidate = {point->location, squaredChord(query, point->coordinates)};
+        offerDistanceHeap(heap, heapSize, k, candidate);
+
+        double diff = query[index->axes[mid]] - point->coordinates[index->axes[mid]];
+        if (diff < 0) {
+            searchNearest(index, lo, mid, query, heap, heapSize, k);
+            lo = mid + 1;
+        } else {
+            searchNearest(index, mid + 1, hi, query, heap, heapSize, k);
+            hi = mid;
+        }
+        if (*heapSize == k && diff * diff >= heap[0].distance) {
+            return;
+        }
+    }
+}
+
+void searchRadius(const SpatialIndex *index, int lo, int hi, const double *query, double limit,
+                  LocationDistance *matches, int maxMatches, int *found) {
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        const SpatialPoint *point = &index->points[mid];
+        double distance = squaredChord(query, point->coordinates);
+        if (distance <= limit) {
+            if (*found < maxMatches) {
+                matches[*found].index = point->location;
+                matches[*found].distance = distance;
+            }
+            (*found)++;
+        }
+
+        double diff = query[index->axes[mid]] - point->coordinates[index->axes[mid]];
+        if (diff * diff <= limit) {
+            searchRadius(index, lo, mid, query, limit, matches, maxMatches, found);
+            lo = mid + 1;
+        } else if (diff < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+}
+
+// Writes up to k nearest locations, closest first, and returns how many were found.
+int findNearestLocations(const SpatialIndex *index, double latitude, double longitude, int k, LocationDistance *nearest) {
+    double query[3];
+    int found = 0;
+    if (k <= 0) {
+        return 0;
+    }
+    toUnitVector(latitude, longitude, query);
+    for (int level = 0; level < SPATIAL_MAX_LEVELS; level++) {
+        int size = 1 << level;
+        if (index->count & size) {
+            searchNearest(index, size - 1, 2 * size - 1, query, nearest, &found, k);
+        }
+    }
+    sortDistanceHeap(nearest, found);
+    for (int i = 0; i < found; i++) {
+        nearest[i].distance = chordToKilometers(nearest[i].distance);
+    }
+    return found;
+}
+
+// Returns the number of locations within radius km; only the first maxMatches are written,
+// in no particular order.
+int findLocationIndicesInRadius(const SpatialIndex *index, double latitude, double longitude, double radius,
+                                LocationDistance *matches, int maxMatches) {
+    double query[3];
+    double angle = radius / EARTH_RADIUS;
+    double chord = 2 * sin((angle < M_PI ? angle : M_PI) / 2);
+    int found = 0;
+    toUnitVector(latitude, longitude, query);
+    for (int level = 0; level < SPATIAL_MAX_LEVELS; level++) {
+        int size = 1 << level;
+        if (index->count & size) {
+            searchRadius(index, size - 1, 2 * size - 1, query, chord * chord, matches, maxMatches, &found);
+        }
+    }
+    for (int i = 0; i < found && i < maxMatches; i++) {
+        matches[i].distance = chordToKilometers(matches[i].distance);
+    }
+    return found;
+}
+
+int compareLocationIndex(const void *a, const void *b) {
+    return ((const LocationDistance *)a)->index - ((const LocationDistance *)b)->index;
+}
+
+
 void printGeoLocation(GeoLocation location) {
     printf("Location: %s\n", location.name);
     printf("Latitude: %.6f, Longitude: %.6f\n", location.latitude, location.longitude);
@@ -53,82 +570,688 @@ void displayLocations(GeoLocation *locations, int numLocations) {
 }
 
 
-GeoLocation findNearestLocation(GeoLocation *locations, int numLocations, GeoLocation refLocation) {
-    double minDistance = -1;
-    GeoLocation nearestLocation;
-    for (int i = 0; i < numLocations; i++) {
-        double distance = haversine(refLocation.latitude, refLocation.longitude, locations[i].latitude, locations[i].longitude);
-        if (minDistance == -1 || distance < minDistance) {
-            minDistance = distance;
-            nearestLocation = locations[i];
-        }
+GeoLocation findNearestLocation(const SpatialIndex *index, GeoLocation *locations, GeoLocation refLocation) {
+    LocationDistance nearest;
+    GeoLocation none = {0, 0, ""};
+    if (findNearestLocations(index, refLocation.latitude, refLocation.longitude, 1, &nearest) == 0) {
+        return none;
     }
-    return nearestLocation;
+    return locations[nearest.index];
 }
 
 
-void findLocationsInRadius(GeoLocation *locations, int numLocations, GeoLocation refLocation, double radius) {
+void findLocationsInRadius(const SpatialIndex *index, GeoLocation *locations, GeoLocation refLocation, double radius) {
+    LocationDistance *matches = (LocationDistance *)malloc((index->count + 1) * sizeof(LocationDistance));
+    if (matches == NULL) {
+        return;
+    }
+    int found = findLocationIndicesInRadius(index, refLocation.latitude, refLocation.longitude, radius, matches, index->count);
+    qsort(matches, found, sizeof(LocationDistance), compareLocationIndex);
+
     printf("Locations within %.2f km of %s:\n", radius, refLocation.name);
+    for (int i = 0; i < found; i++) {
+        printGeoLocation(locations[matches[i].index]);
+    }
+    free(matches);
+}
+
+int compareLocationDistance(const void *a, const void *b) {
+    const LocationDistance *left = (const LocationDistance *)a;
+    const LocationDistance *right = (const LocationDistance *)b;
+    if (left->distance != right->distance) {
+        return left->distance < right->distance ? -1 : 1;
+    }
+    return left->index - right->index;
+}
+
+// Ranks locations by distance from a reference point without moving the location records.
+// For k < numLocations a bounded max-heap keeps only the k best candidates (O(n log k));
+// otherwise all index/distance pairs are sorted. Returns the number written to ranked.
+int rankLocationsByDistance(const GeoLocation *locations, int numLocations, GeoLocation refLocation,
+                            int k, LocationDistance *ranked) {
+    if (k <= 0 || numLocations <= 0) {
+        return 0;
+    }
+    if (k >= numLocations) {
+        for (int i = 0; i < numLocations; i++) {
+            ranked[i].index = i;
+            ranked[i].distance = haversine(refLocation.latitude, refLocation.longitude, locations[i].latitude, locations[i].longitude);
+        }
+        qsort(ranked, numLocations, sizeof(LocationDistance), compareLocationDistance);
+        return numLocations;
+    }
+
+    int size = 0;
     for (int i = 0; i < numLocations; i++) {
-        double distance = haversine(refLocation.latitude, refLocation.longitude, locations[i].latitude, locations[i].longitude);
-        if (distance <= radius) {
-            printGeoLocation(locations[i]);
+        LocationDistance candidate = {i, haversine(refLocation.latitude, refLocation.longitude, locations[i].latitude, locations[i].longitude)};
+        offerDistanceHeap(ranked, &size, k, candidate);
+    }
+    qsort(ranked, size, sizeof(LocationDistance), compareLocationDistance);
+    return size;
+}
+
+// ranked must hold numLocations entries; it is caller-owned so repeated calls do not allocate.
+void sortLocationsByDistance(const GeoLocation *locations, int numLocations, GeoLocation refLocation, LocationDistance *ranked) {
+    int count = rankLocationsByDistance(locations, numLocations, refLocation, numLocations, ranked);
+
+    printf("\nLocations sorted by distance from %s:\n", refLocation.name);
+    for (int i = 0; i < count; i++) {
+        printGeoLocation(locations[ranked[i].index]);
+        printf("Distance: %.2f km\n", ranked[i].distance);
+    }
+}
+
+void getUserLocationInput(GeoLocation *location) {
+    printf("Enter the name of the location: ");
+    scanf("%s", location->name);
+
+    printf("Enter the latitude: ");
+    scanf("%lf", &location->latitude);
+
+    printf("Enter the longitude: ");
+    scanf("%lf", &location->longitude);
+}
+
+double wallSeconds() {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+char *readWholeFile(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *buffer = (char *)malloc(size > 0 ? (size_t)size + 1 : 1);
+    if (buffer == NULL || size < 0 || fread(buffer, 1, (size_t)size, file) != (size_t)size) {
+        free(buffer);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    buffer[size] = '\0';
+    *length = (size_t)size;
+    return buffer;
+}
+
+const char *findInRange(const char *start, const char *end, const char *needle) {
+    size_t needleLength = strlen(needle);
+    while (end - start >= (long)needleLength) {
+        const char *candidate = (const char *)memchr(start, needle[0], (size_t)(end - start) - needleLength + 1);
+        if (candidate == NULL) {
+            return NULL;
         }
+        if (memcmp(candidate, needle, needleLength) == 0) {
+            return candidate;
+        }
+        start = candidate + 1;
     }
+    return NULL;
 }
 
-void sortLocationsByDistance(GeoLocation *locations, int numLocations, GeoLocation refLocation) {
-    double *distances = (double *)malloc(numLocations * sizeof(double));
+void freeCatalogBuilder(CatalogBuilder *builder) {
+    free(builder->latitude);
+    free(builder->longitude);
+    free(builder->nameOffsets);
+    free(builder->names);
+    memset(builder, 0, sizeof(*builder));
+}
+
+int appendCatalogSite(CatalogBuilder *builder, const char *name, size_t nameLength, double latitude, double longitude) {
+    if (latitude < -90 || latitude > 90 || longitude < -180 || longitude > 180) {
+        return 0;
+    }
+    if (builder->count == builder->capacity) {
+        int capacity = builder->capacity ? builder->capacity * 2 : 1024;
+        double *latitudes = (double *)realloc(builder->latitude, capacity * sizeof(double));
+        if (latitudes == NULL) return 0;
+        builder->latitude = latitudes;
+        double *longitudes = (double *)realloc(builder->longitude, capacity * sizeof(double));
+        if (longitudes == NULL) return 0;
+        builder->longitude = longitudes;
+        int32_t *offsets = (int32_t *)realloc(builder->nameOffsets, capacity * sizeof(int32_t));
+        if (offsets == NULL) return 0;
+        builder->nameOffsets = offsets;
+        builder->capacity = capacity;
+    }
+    if (builder->namesBytes + nameLength + 1 > builder->namesCapacity) {
+        size_t capacity = builder->namesCapacity ? builder->namesCapacity : 16384;
+        while (builder->namesBytes + nameLength + 1 > capacity) {
+            capacity *= 2;
+        }
+        char *names = (char *)realloc(builder->names, capacity);
+        if (names == NULL) return 0;
+        builder->names = names;
+        builder->namesCapacity = capacity;
+    }
+    builder->latitude[builder->count] = latitude;
+    builder->longitude[builder->count] = longitude;
+    builder->nameOffsets[builder->count] = (int32_t)builder->namesBytes;
+    memcpy(builder->names + builder->namesBytes, name, nameLength);
+    builder->names[builder->namesBytes + nameLength] = '\0';
+    builder->namesBytes += nameLength + 1;
+    builder->count++;
+    return 1;
+}
+
+int parseCatalogNumber(const char *start, size_t length, double *value) {
+    char buffer[64];
+    char *end;
+    while (length > 0 && (*start == ' ' || *start == '"')) {
+        start++;
+        length--;
+    }
+    if (length == 0 || length >= sizeof(buffer)) {
+        return 0;
+    }
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+    *value = strtod(buffer, &end);
+    return end != buffer;
+}
+
+int matchesColumn(const char *start, size_t length, const char *name) {
+    size_t nameLength = strlen(name);
+    if (length < nameLength) {
+        return 0;
+    }
+    for (size_t i = 0; i < nameLength; i++) {
+        char c = start[i];
+        if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        if (c != name[i]) return 0;
+    }
+    return 1;
+}
+
+// CSV with one site per line. Columns default to name,latitude,longitude; a header row,
+// if present, picks them by name (name/station/site/code, lat*, lon*/lng*).
+int parseCatalogCSV(CatalogBuilder *builder, const char *text, size_t length) {
+    const char *cursor = text;
+    const char *end = text + length;
+    int nameColumn = 0, latitudeColumn = 1, longitudeColumn = 2;
+    int firstLine = 1, rejected = 0;
 
+    while (cursor < end) {
+        const char *lineEnd = (const char *)memchr(cursor, '\n', (size_t)(end - cursor));
+        const char *next = lineEnd ? lineEnd + 1 : end;
+        if (lineEnd == NULL) lineEnd = end;
+        if (lineEnd > cursor && lineEnd[-1] == '\r') lineEnd--;
+
+        const char *fieldStart[CATALOG_MAX_COLUMNS];
+        size_t fieldLength[CATALOG_MAX_COLUMNS];
+        int fields = 0;
+        const char *field = cursor;
+        while (fields < CATALOG_MAX_COLUMNS) {
+            const char *comma = (const char *)memchr(field, ',', (size_t)(lineEnd - field));
+            const char *fieldEnd = comma ? comma : lineEnd;
+            fieldStart[fields] = field;
+            fieldLength[fields] = (size_t)(fieldEnd - field);
+            fields++;
+            if (comma == NULL) break;
+            field = comma + 1;
+        }
+
+        double latitude, longitude;
+        int valid = lineEnd > cursor && fields > latitudeColumn && fields > longitudeColumn &&
+                    parseCatalogNumber(fieldStart[latitudeColumn], fieldLength[latitudeColumn], &latitude) &&
+                    parseCatalogNumber(fieldStart[longitudeColumn], fieldLength[longitudeColumn], &longitude);
+        if (!valid && firstLine) {
+            for (int i = 0; i < fields; i++) {
+                const char *name = fieldStart[i];
+                size_t nameLength = fieldLength[i];
+                while (nameLength > 0 && (*name == ' ' || *name == '"')) {
+                    name++;
+                    nameLength--;
+                }
+                if (matchesColumn(name, nameLength, "lat")) latitudeColumn = i;
+                else if (matchesColumn(name, nameLength, "lon") || matchesColumn(name, nameLength, "lng")) longitudeColumn = i;
+                else if (matchesColumn(name, nameLength, "name") || matchesColumn(name, nameLength, "station") ||
+                         matchesColumn(name, nameLength, "site") || matchesColumn(name, nameLength, "code")) nameColumn = i;
+            }
+        } else if (lineEnd > cursor) {
+            const char *name = nameColumn < fields ? fieldStart[nameColumn] : "";
+            size_t nameLength = nameColumn < fields ? fieldLength[nameColumn] : 0;
+            if (nameLength >= 2 && name[0] == '"' && name[nameLength - 1] == '"') {
+                name++;
+                nameLength -= 2;
+            }
+            if (!valid || !appendCatalogSite(builder, name, nameLength, latitude, longitude)) {
+                rejected++;
+            }
+        }
+        firstLine = 0;
+        cursor = next;
+    }
+    return rejected;
+}
+
+// Point features only: each "Feature" contributes its first coordinate pair, which
+// GeoJSON orders longitude first, and its "name" property if it has one.
+int parseCatalogGeoJSON(CatalogBuilder *builder, const char *text, size_t length) {
+    const char *end = text + length;
+    const char *feature = findInRange(text, end, "\"Feature\"");
+    int rejected = 0;
+
+    while (feature != NULL) {
+        const char *next = findInRange(feature + 9, end, "\"Feature\"");
+        const char *limit = next ? next : end;
+        const char *coordinates = findInRange(feature, limit, "\"coordinates\"");
+        const char *open = coordinates ? (const char *)memchr(coordinates, '[', (size_t)(limit - coordinates)) : NULL;
+        double latitude = 0, longitude = 0;
+        int valid = 0;
+
+        if (open != NULL) {
+            char *numberEnd;
+            longitude = strtod(open + 1, &numberEnd);
+            const char *comma = numberEnd != open + 1 ? (const char *)memchr(numberEnd, ',', (size_t)(limit - numberEnd)) : NULL;
+            if (comma != NULL) {
+                char *latitudeEnd;
+                latitude = strtod(comma + 1, &latitudeEnd);
+                valid = latitudeEnd != comma + 1;
+            }
+        }
+
+        const char *name = "";
+        size_t nameLength = 0;
+        const char *key = findInRange(feature, limit, "\"name\"");
+        if (key != NULL) {
+            const char *quote = (const char *)memchr(key + 6, '"', (size_t)(limit - key - 6));
+            const char *close = quote ? (const char *)memchr(quote + 1, '"', (size_t)(limit - quote - 1)) : NULL;
+            if (close != NULL) {
+                name = quote + 1;
+                nameLength = (size_t)(close - name);
+            }
+        }
+
+        if (!valid || !appendCatalogSite(builder, name, nameLength, latitude, longitude)) {
+            rejected++;
+        }
+        feature = next;
+    }
+    return rejected;
+}
+
+size_t catalogCacheSize(int count, size_t namesBytes) {
+    return sizeof(CatalogCacheHeader) + (size_t)count * (5 * sizeof(double) + sizeof(int32_t)) + namesBytes;
+}
+
+// Written to a temporary name and renamed into place, so a reader never maps a partial cache.
+int writeCatalogCache(const CatalogBuilder *builder, const char *cachePath, int64_t sourceSize, int64_t sourceModified) {
+    char temporaryPath[CATALOG_PATH_LEN];
+    CatalogCacheHeader header;
+    int count = builder->count;
+
+    double *vectors = (double *)malloc(3 * (count + 1) * sizeof(double));
+    if (vectors == NULL) {
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        double coordinates[3];
+        toUnitVector(builder->latitude[i], builder->longitude[i], coordinates);
+        vectors[i] = coordinates[0];
+        vectors[count + i] = coordinates[1];
+        vectors[2 * count + i] = coordinates[2];
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CATALOG_CACHE_MAGIC, sizeof(header.magic));
+    header.sourceSize = sourceSize;
+    header.sourceModified = sourceModified;
+    header.count = count;
+    header.namesBytes = (int32_t)builder->namesBytes;
+
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", cachePath);
+    FILE *file = fopen(temporaryPath, "wb");
+    if (file == NULL) {
+        free(vectors);
+        return 0;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(builder->latitude, sizeof(double), count, file) == (size_t)count &&
+             fwrite(builder->longitude, sizeof(double), count, file) == (size_t)count &&
+             fwrite(vectors, sizeof(double), 3 * (size_t)count, file) == 3 * (size_t)count &&
+             fwrite(builder->nameOffsets, sizeof(int32_t), count, file) == (size_t)count &&
+             fwrite(builder->names, 1, builder->namesBytes, file) == builder->namesBytes;
+    ok = fclose(file) == 0 && ok;
+    free(vectors);
+    if (!ok) {
+        remove(temporaryPath);
+        return 0;
+    }
+#ifdef _WIN32
+    remove(cachePath);
+#endif
+    if (rename(temporaryPath, cachePath) != 0) {
+        remove(temporaryPath);
+        return 0;
+    }
+    return 1;
+}
+
+void closeStationCatalog(StationCatalog *catalog) {
+    if (catalog->mapping != NULL) {
+#ifdef _WIN32
+        free(catalog->mapping);
+#else
+        munmap(catalog->mapping, catalog->mappingSize);
+#endif
+    }
+    memset(catalog, 0, sizeof(*catalog));
+}
 
+// Maps the cache and points the catalog's arrays straight into it. A cache whose recorded
+// source size or modification time differs from the source is treated as stale.
+int mapCatalogCache(const char *cachePath, StationCatalog *catalog, int checkSource, int64_t sourceSize, int64_t sourceModified) {
+    size_t size;
+#ifdef _WIN32
+    char *mapping = readWholeFile(cachePath, &size);
+    if (mapping == NULL) {
+        return 0;
+    }
+#else
+    struct stat info;
+    int fd = open(cachePath, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CatalogCacheHeader)) {
+        close(fd);
+        return 0;
+    }
+    size = (size_t)info.st_size;
+    char *mapping = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return 0;
+    }
+#endif
+    catalog->mapping = mapping;
+    catalog->mappingSize = size;
+
+    const CatalogCacheHeader *header = (const CatalogCacheHeader *)mapping;
+    if (size < sizeof(CatalogCacheHeader) || memcmp(header->magic, CATALOG_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->count < 0 || header->namesBytes < 0 ||
+        size != catalogCacheSize(header->count, (size_t)header->namesBytes) ||
+        (checkSource && (header->sourceSize != sourceSize || header->sourceModified != sourceModified))) {
+        closeStationCatalog(catalog);
+        return 0;
+    }
+
+    int count = header->count;
+    const double *arrays = (const double *)(mapping + sizeof(CatalogCacheHeader));
+    catalog->count = count;
+    catalog->latitude = arrays;
+    catalog->longitude = arrays + count;
+    // The batch kernels only read through these, so the read-only mapping is safe to share.
+    catalog->vectors.x = (double *)(arrays + 2 * count);
+    catalog->vectors.y = (double *)(arrays + 3 * count);
+    catalog->vectors.z = (double *)(arrays + 4 * count);
+    catalog->vectors.count = count;
+    catalog->nameOffsets = (const int32_t *)(arrays + 5 * count);
+    catalog->names = (const char *)(catalog->nameOffsets + count);
+    return 1;
+}
+
+const char *stationCatalogName(const StationCatalog *catalog, int i) {
+    return catalog->names + catalog->nameOffsets[i];
+}
+
+// Loads a CSV or GeoJSON site list through its binary cache (path + ".cache"): a fresh
+// cache is mapped directly, otherwise the source is parsed and the cache rewritten.
+// Sets *fromCache to report which path was taken.
+int loadStationCatalog(const char *path, StationCatalog *catalog, int *fromCache) {
+    char cachePath[CATALOG_PATH_LEN];
+    struct stat info;
+    memset(catalog, 0, sizeof(*catalog));
+    *fromCache = 0;
+    if (snprintf(cachePath, sizeof(cachePath), "%s%s", path, CATALOG_CACHE_SUFFIX) >= (int)sizeof(cachePath) - 4) {
+        return 0;
+    }
+
+    int haveSource = stat(path, &info) == 0;
+    int64_t sourceSize = haveSource ? (int64_t)info.st_size : 0;
+    int64_t sourceModified = haveSource ? (int64_t)info.st_mtime : 0;
+    if (mapCatalogCache(cachePath, catalog, haveSource, sourceSize, sourceModified)) {
+        *fromCache = 1;
+        return 1;
+    }
+    if (!haveSource) {
+        return 0;
+    }
+
+    size_t length;
+    char *text = readWholeFile(path, &length);
+    if (text == NULL) {
+        return 0;
+    }
+    CatalogBuilder builder;
+    memset(&builder, 0, sizeof(builder));
+    const char *first = text;
+    while (first < text + length && (*first == ' ' || *first == '\t' || *first == '\r' || *first == '\n')) {
+        first++;
+    }
+    int rejected = (first < text + length && *first == '{') ? parseCatalogGeoJSON(&builder, text, length)
+                                                            : parseCatalogCSV(&builder, text, length);
+    free(text);
+    if (rejected > 0) {
+        printf("Skipped %d malformed site records in %s\n", rejected, path);
+    }
+
+    int ok = writeCatalogCache(&builder, cachePath, sourceSize, sourceModified) &&
+             mapCatalogCache(cachePath, catalog, 1, sourceSize, sourceModified);
+    freeCatalogBuilder(&builder);
+    return ok;
+}
+
+void loadStationCatalogs(int numPaths, char **paths, GeoLocation refLocation) {
+    for (int i = 0; i < numPaths; i++) {
+        StationCatalog catalog;
+        LocationDistance nearest;
+        int fromCache;
+        double start = wallSeconds();
+        if (!loadStationCatalog(paths[i], &catalog, &fromCache)) {
+            printf("Error loading station catalog %s.\n", paths[i]);
+            continue;
+        }
+        printf("Loaded %d sites from %s in %.2f ms (%s)\n", catalog.count, paths[i],
+               (wallSeconds() - start) * 1e3, fromCache ? "binary cache" : "parsed, cache written");
+
+        if (findNearestInCatalog(&catalog.vectors, refLocation.latitude, refLocation.longitude, &nearest)) {
+            printf("Nearest site to %s: %s (%.6f, %.6f), %.2f km\n", refLocation.name,
+                   stationCatalogName(&catalog, nearest.index), catalog.latitude[nearest.index],
+                   catalog.longitude[nearest.index], nearest.distance);
+        }
+        closeStationCatalog(&catalog);
+    }
+}
+
+double randomCoordinate(double range) {
+    return (rand() / (double)RAND_MAX * 2 - 1) * range;
+}
+
+void benchmarkSpatialIndex() {
+    int numLocations = 50000, numQueries = 200, mismatches = 0;
+    GeoLocation *catalog = (GeoLocation *)malloc(numLocations * sizeof(GeoLocation));
+    LocationDistance *matches = (LocationDistance *)malloc(numLocations * sizeof(LocationDistance));
+    SpatialIndex index;
+    if (catalog == NULL || matches == NULL) {
+        free(catalog);
+        free(matches);
+        return;
+    }
+    srand(42);
     for (int i = 0; i < numLocations; i++) {
-        distances[i] = haversine(refLocation.latitude, refLocation.longitude, locations[i].latitude, locations[i].longitude);
+        catalog[i].latitude = randomCoordinate(90);
+        catalog[i].longitude = randomCoordinate(180);
+        snprintf(catalog[i].name, sizeof(catalog[i].name), "Site %d", i);
     }
 
+    initializeSpatialIndex(&index);
+    clock_t start = clock();
+    for (int i = 0; i < numLocations; i++) {
+        insertSpatialIndex(&index, &catalog[i], i);
+    }
+    double insertTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+    buildSpatialIndex(&index, catalog, numLocations);
+    double buildTime = (double)(clock() - start) / CLOCKS_PER_SEC;
 
-    for (int i = 0; i < numLocations - 1; i++) {
-        for (int j = i + 1; j < numLocations; j++) {
-            if (distances[i] > distances[j]) {
-                
-                double tempDist = distances[i];
-                distances[i] = distances[j];
-                distances[j] = tempDist;
+    double bruteTime = 0, indexTime = 0;
+    for (int q = 0; q < numQueries; q++) {
+        double latitude = randomCoordinate(90), longitude = randomCoordinate(180);
+        LocationDistance nearest[5];
 
-            
-                GeoLocation tempLoc = locations[i];
-                locations[i] = locations[j];
-                locations[j] = tempLoc;
+        start = clock();
+        double bestDistance = -1;
+        int inRadius = 0;
+        for (int i = 0; i < numLocations; i++) {
+            double distance = haversine(latitude, longitude, catalog[i].latitude, catalog[i].longitude);
+            if (bestDistance == -1 || distance < bestDistance) {
+                bestDistance = distance;
+            }
+            if (distance <= 200.0) {
+                inRadius++;
             }
         }
+        bruteTime += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+        int found = findNearestLocations(&index, latitude, longitude, 5, nearest);
+        int indexedInRadius = findLocationIndicesInRadius(&index, latitude, longitude, 200.0, matches, numLocations);
+        indexTime += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        if (found != 5 || fabs(nearest[0].distance - bestDistance) > 1e-6 || indexedInRadius != inRadius) {
+            mismatches++;
+        }
     }
 
+    printf("\nSpatial index over %d locations: bulk build %.1f ms, %d incremental inserts %.1f ms\n",
+           numLocations, buildTime * 1e3, numLocations, insertTime * 1e3);
+    printf("%d nearest + 200 km radius queries: linear scan %.1f ms, index %.1f ms, %d mismatches\n",
+           numQueries, bruteTime * 1e3, indexTime * 1e3, mismatches);
 
-    printf("\nLocations sorted by distance from %s:\n", refLocation.name);
+    freeSpatialIndex(&index);
+    free(catalog);
+    free(matches);
+}
+
+void benchmarkDistanceRanking() {
+    int numLocations = 200000, k = 10;
+    GeoLocation *catalog = (GeoLocation *)malloc(numLocations * sizeof(GeoLocation));
+    LocationDistance *ranked = (LocationDistance *)malloc(numLocations * sizeof(LocationDistance));
+    GeoLocation reference = {35.6762, 139.6503, "Tokyo"};
+    if (catalog == NULL || ranked == NULL) {
+        free(catalog);
+        free(ranked);
+        return;
+    }
+    srand(7);
     for (int i = 0; i < numLocations; i++) {
-        printGeoLocation(locations[i]);
-        printf("Distance: %.2f km\n", distances[i]);
+        catalog[i].latitude = randomCoordinate(90);
+        catalog[i].longitude = randomCoordinate(180);
+        catalog[i].name[0] = '\0';
     }
 
-    free(distances);
+    clock_t start = clock();
+    rankLocationsByDistance(catalog, numLocations, reference, numLocations, ranked);
+    double fullTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+    double kthDistance = ranked[k - 1].distance;
+
+    start = clock();
+    int found = rankLocationsByDistance(catalog, numLocations, reference, k, ranked);
+    double topTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("Ranking %d locations: full order %.1f ms, top %d %.1f ms (%s)\n",
+           numLocations, fullTime * 1e3, k, topTime * 1e3,
+           found == k && ranked[k - 1].distance == kthDistance ? "consistent" : "MISMATCH");
+
+    free(catalog);
+    free(ranked);
 }
 
-void getUserLocationInput(GeoLocation *location) {
-    printf("Enter the name of the location: ");
-    scanf("%s", location->name);
+void benchmarkBatchHaversine() {
+    int numLocations = 200000, numQueries = 20;
+    GeoLocation *sites = (GeoLocation *)malloc(numLocations * sizeof(GeoLocation));
+    double *distances = (double *)malloc(numLocations * sizeof(double));
+    double *reference = (double *)malloc(numLocations * sizeof(double));
+    LocationCatalog catalog;
+    if (sites == NULL || distances == NULL || reference == NULL) {
+        free(sites);
+        free(distances);
+        free(reference);
+        return;
+    }
+    srand(11);
+    for (int i = 0; i < numLocations; i++) {
+        sites[i].latitude = randomCoordinate(90);
+        sites[i].longitude = randomCoordinate(180);
+        sites[i].name[0] = '\0';
+    }
+    if (!buildLocationCatalog(&catalog, sites, numLocations)) {
+        free(sites);
+        free(distances);
+        free(reference);
+        return;
+    }
 
-    printf("Enter the latitude: ");
-    scanf("%lf", &location->latitude);
+    double scalarTime = 0, batchTime = 0, maxError = 0;
+    int radiusMismatches = 0;
+    for (int q = 0; q < numQueries; q++) {
+        double latitude = randomCoordinate(90), longitude = randomCoordinate(180);
+        int inRadius = 0;
 
-    printf("Enter the longitude: ");
-    scanf("%lf", &location->longitude);
+        clock_t start = clock();
+        for (int i = 0; i < numLocations; i++) {
+            reference[i] = haversine(latitude, longitude, sites[i].latitude, sites[i].longitude);
+        }
+        scalarTime += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+        batchHaversine(&catalog, latitude, longitude, distances);
+        batchTime += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        for (int i = 0; i < numLocations; i++) {
+            double error = fabs(distances[i] - reference[i]);
+            if (error > maxError) {
+                maxError = error;
+            }
+            if (reference[i] <= 300.0) {
+                inRadius++;
+            }
+        }
+        if (scanCatalogRadius(&catalog, latitude, longitude, 300.0, NULL, 0) != inRadius) {
+            radiusMismatches++;
+        }
+    }
+
+    printf("Distances to %d sites x %d queries: scalar haversine %.1f ms, batched %.1f ms, max error %.2e km, %d radius mismatches\n",
+           numLocations, numQueries, scalarTime * 1e3, batchTime * 1e3, maxError, radiusMismatches);
+
+    freeLocationCatalog(&catalog);
+    free(sites);
+    free(distances);
+    free(reference);
 }
 
-int main() {
+int main(int argc, char **argv) {
     GeoLocation locations[10]; 
+    LocationDistance ranked[10];
     GeoLocation userLocation = {37.7749, -122.4194, "User's Location"};
     int numLocations = 5;
+    SpatialIndex index;
+
+    if (argc > 1) {
+        loadStationCatalogs(argc - 1, argv + 1, userLocation);
+        return 0;
+    }
 
     storeLocations(locations);
+    initializeSpatialIndex(&index);
+    buildSpatialIndex(&index, locations, numLocations);
 
     printf("\nWould you like to add a new location? (y/n): ");
     char userChoice;
@@ -137,6 +1260,7 @@ int main() {
         GeoLocation newLocation;
         getUserLocationInput(&newLocation);
         locations[numLocations] = newLocation;
+        insertSpatialIndex(&index, &newLocation, numLocations);
         numLocations++;
     }
 
@@ -144,16 +1268,21 @@ int main() {
     printf("\nAll Stored Locations:\n");
     displayLocations(locations, numLocations);
 
-    GeoLocation nearest = findNearestLocation(locations, numLocations, userLocation);
+    GeoLocation nearest = findNearestLocation(&index, locations, userLocation);
     printf("\nThe nearest location to %s is:\n", userLocation.name);
     printGeoLocation(nearest);
 
     double distance = haversine(userLocation.latitude, userLocation.longitude, nearest.latitude, nearest.longitude);
     printf("\nDistance to nearest location: %.2f km\n", distance);
 
-    findLocationsInRadius(locations, numLocations, userLocation, 500.0);
+    findLocationsInRadius(&index, locations, userLocation, 500.0);
+
+    sortLocationsByDistance(locations, numLocations, userLocation, ranked);
 
-    sortLocationsByDistance(locations, numLocations, userLocation);
+    freeSpatialIndex(&index);
+    benchmarkSpatialIndex();
+    benchmarkDistanceRanking();
+    benchmarkBatchHaversine();
 
     return 0;
 }
@@ -2,54 +2,506 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #define MAX_STATIONS 100
-#define MAX_EVENT_RECORDS 500
 #define MAX_SEISMIC_DATA_POINTS 1000
+#define INITIAL_EVENT_CAPACITY 1024
+#define INITIAL_STATION_CAPACITY 16
+#define EVENTS_PER_STATION 10
+#define POOL_MAX_WORKERS 64
+#define POOL_CHUNK_STATIONS 8
+#define SCALING_STATIONS 10000
+#define REPORT_BATCH_RECORDS 4096
+#define REPORT_BATCHES 4
+#define REPORT_BUFFER_BYTES (1 << 20)
+#define EARTH_RADIUS_KM 6371.0
+#define NS_PER_SECOND 1000000000LL
+#define GR_MIN_MAGNITUDE -2.0
+#define GR_BIN_WIDTH 0.1
+#define GR_BINS 160
+#define GR_BIN_EPSILON 1e-4
+#define GR_COMPLETENESS_MAGNITUDE 4.0
+#define GR_MIN_FIT_EVENTS 10
+#define GR_REGION_DEG 30
+#define GR_REGIONS ((180 / GR_REGION_DEG) * (360 / GR_REGION_DEG))
+#define ASSOCIATION_RADIUS_KM 2000.0
+#define ASSOCIATION_TOLERANCE_S 5.0
+#define ASSOCIATION_MIN_STATIONS 4
+#define ASSOCIATION_MATCH_S 2.0
+#define ASSOCIATION_SEED_SPACINGS 2.0
+#define ASSOCIATION_SCAN_NODES 3
+#define ASSOCIATION_SCAN_DEPTHS 1
+#define ASSOCIATION_SCAN_LEVELS 5
+#define ASSOCIATION_REFINE_NODES 2
+#define ASSOCIATION_SCAN_REFINE 2.0
+#define ASSOCIATION_DEMO_RANGE_KM 1000.0
+#define ASSOCIATION_DEMO_PICK_NOISE_S 0.25
+#define LOCATE_MAX_DEPTH_KM 700.0
+#define LOCATE_DEPTH_STEP_KM 5.0
+#define LOCATE_MAX_DISTANCE_KM 2500.0
+#define LOCATE_CHORD_SAMPLES 1024
+#define LOCATE_SPAN_DEG 2.5
+#define LOCATE_COARSE_STEP_DEG 0.25
+#define LOCATE_COARSE_DEPTH_STEP_KM 20.0
+#define LOCATE_REFINEMENTS 4
+#define LOCATE_OUTLIER_S 3.0
+#define LOCATE_CLIP_S 10.0
+#define LOCATE_LATENCY_BUDGET_MS 250.0
 
 typedef struct {
     float latitude;
     float longitude;
     float depth;      
     float magnitude;   
-    char date[11];    
-    char time[9];     
+    int64_t timestamp_ns;  // nanoseconds since 1970-01-01 UTC
     bool event_detected;
 } SeismicEvent;
 
+// Magnitude-frequency statistics kept up to date one event at a time; all zeros is the
+// empty state. bins[k] counts magnitudes in [GR_MIN_MAGNITUDE + k * GR_BIN_WIDTH, +
+// GR_BIN_WIDTH), with magnitudes outside the range clamped into the end bins; bin edges
+// are matched within GR_BIN_EPSILON bin widths, since a float tenth such as 4.1f sits
+// just below its decimal value. The sums of
+// the excess m - GR_COMPLETENESS_MAGNITUDE over events at or above it are all the
+// b-value needs.
+typedef struct {
+    uint32_t bins[GR_BINS];
+    long count;
+    long complete_count;
+    double excess_sum;
+    double excess_squares;
+} MagnitudeStats;
+
+typedef struct {
+    bool valid;
+    long count;
+    double completeness;
+    double b_value;
+    double b_error;
+    double b_lower;
+    double b_upper;
+    double a_value;
+    double a_error;
+} GutenbergRichterFit;
+
 typedef struct {
     int station_id;
     char location[50];
-    SeismicEvent events[MAX_EVENT_RECORDS];
+    float latitude;
+    float longitude;
     int event_count;
+    MagnitudeStats magnitudes;
 } SeismicStation;
 
+// Network-wide event storage, one array per field, so scans touch only the columns they
+// need. Rows are appended in arrival order. The index lists every row in time order in
+// time_rows (the network-wide view), and the rows of station s, also in time order, in
+// station_rows[station_offsets[s] .. station_offsets[s + 1]); equal timestamps keep row
+// order. It is rebuilt lazily once rows have been added since the last build.
+typedef struct {
+    int *station;
+    int64_t *timestamp_ns;
+    float *latitude;
+    float *longitude;
+    float *depth;
+    float *magnitude;
+    bool *event_detected;
+    int count;
+    int capacity;
+    int *station_offsets;
+    int *station_rows;
+    int *time_rows;
+    int indexed_count;
+    int indexed_stations;
+} SeismicEventTable;
+
 typedef struct {
-    SeismicStation stations[MAX_STATIONS];
+    int64_t timestamp_ns;
+    int row;
+} EventTimeKey;
+
+// magnitudes and region_magnitudes (GR_REGION_DEG latitude/longitude cells, by event
+// location) are updated with every recorded or removed row, like each station's own.
+typedef struct {
+    SeismicStation *stations;
     int station_count;
+    int station_capacity;
+    SeismicEventTable events;
+    MagnitudeStats magnitudes;
+    MagnitudeStats region_magnitudes[GR_REGIONS];
 } SeismicNetwork;
 
+// Text sink for reports: either a stream, written through directly, or a growable
+// in-memory buffer that parallel workers fill and the caller emits in station order.
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+    FILE *stream;
+} ReportBuffer;
+
+typedef enum {
+    REPORT_TEXT,
+    REPORT_JSONL,
+    REPORT_BINARY
+} ReportFormat;
+
+typedef enum {
+    REPORT_STATION_ID,
+    REPORT_STATION,
+    REPORT_EVENT,
+    REPORT_ALERT,
+    REPORT_IMPACT,
+    REPORT_RISK,
+    REPORT_SUMMARY,
+    REPORT_FORMATTED
+} ReportRecordKind;
+
+// One queued report entry. Records hold copies, so the network may change or be freed
+// once a record has been queued. The exception is REPORT_FORMATTED, text already in the
+// writer's format that is only referenced and must outlive the next flush.
+typedef struct {
+    ReportRecordKind kind;
+    union {
+        SeismicEvent event;
+        struct {
+            int station_id;
+            int event_count;
+            char location[50];
+        } station;
+        struct {
+            long total_events;
+            long strong_events;
+            GutenbergRichterFit fit;
+        } risk;
+        struct {
+            long alerts;
+            long events_analyzed;
+            long impacts[3];
+        } summary;
+        struct {
+            const char *data;
+            size_t length;
+        } formatted;
+    };
+} ReportRecord;
+
+typedef struct {
+    ReportRecord records[REPORT_BATCH_RECORDS];
+    int count;
+} ReportBatch;
+
+// A single producer queues records into a ring of REPORT_BATCHES batches. A background
+// thread formats each handed-off batch into one reusable buffer and writes it with a
+// single fwrite, so the producer waits only when every batch is still queued. If the
+// thread cannot be started, batches are formatted and written by the producer.
+typedef struct {
+    FILE *stream;
+    ReportFormat format;
+    ReportBatch *batches;
+    int filling;
+    int queued;
+    int next_write;
+    ReportBuffer text;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    pthread_cond_t drained;
+    bool threaded;
+    bool closing;
+} ReportWriter;
+
+// Station ranges are packed as begin << 32 | end so an owner can take a chunk from the
+// front, and a thief can split off the back half, with a single compare-and-swap.
+typedef struct {
+    _Alignas(64) _Atomic uint64_t range;
+    int id;
+    struct StationPool *pool;
+    ReportBuffer output;
+    long events_analyzed;
+    long alerts;
+    long high_impact;
+    long moderate_impact;
+    long low_impact;
+} PoolWorker;
+
+typedef void (*StationTask)(void *context, PoolWorker *worker, int station);
+
+typedef struct {
+    int worker;
+    size_t offset;
+    size_t length;
+} StationOutput;
+
+typedef struct StationPool {
+    pthread_t threads[POOL_MAX_WORKERS];
+    PoolWorker workers[POOL_MAX_WORKERS];
+    int worker_count;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned long generation;
+    int active;
+    bool stopping;
+    StationTask task;
+    void *context;
+    StationOutput *station_output;
+} StationPool;
+
+typedef struct {
+    int station;
+    int row;
+    double time;
+    float magnitude;
+} Detection;
+
+// One network event built from the detections of several stations. Its contributing
+// stations and their arrival times are stations[first_station .. first_station +
+// station_count) and arrival_times[...] of the AssociationResult. Until the event is
+// located, origin_time and position are those of the first-arriving station.
+typedef struct {
+    double origin_time;
+    float latitude;
+    float longitude;
+    float depth;
+    float magnitude;
+    float rms;
+    bool located;
+    int first_station;
+    int station_count;
+} NetworkEvent;
+
+// detection_event gives, for each input detection, the index of the event it joined, or
+// -1 if it was left unassociated.
+typedef struct {
+    NetworkEvent *events;
+    int event_count;
+    int *stations;
+    double *arrival_times;
+    int *detection_event;
+    int detection_count;
+    int unassociated;
+} AssociationResult;
+
+typedef struct {
+    double top_km;
+    double velocity;
+} VelocityLayer;
+
+// First-arrival P times for the layered model, by source depth (rows) and by chord
+// between source and station on the unit sphere (columns). Indexing by chord rather
+// than arc lets the misfit kernel skip the inverse trig per station.
+typedef struct {
+    float *times;
+    int depth_count;
+    int chord_count;
+    double depth_step;
+    double chord_step;
+} TravelTimeTable;
+
+// Trial source for a seed detection during association: a position on the unit sphere,
+// a depth, and the origin time that puts the seed's arrival on the model.
+typedef struct {
+    double position[3];
+    double depth;
+    double origin;
+    int matches;
+    double score;
+} AssociationHypothesis;
+
+// A seed and its neighbours for scanSeedHypotheses: the neighbours' station unit vectors
+// and arrivals in structure-of-arrays form, as in LocatorJob.
+typedef struct {
+    const TravelTimeTable *table;
+    int pick_count;
+    double *x;
+    double *y;
+    double *z;
+    double *arrival;
+    double seed[3];
+    double seed_arrival;
+} AssociationScan;
+
+// Bucket queue of association seeds by key, with each bucket a doubly linked list so a
+// seed can be moved when its key drops.
+typedef struct {
+    int *head;
+    int *next;
+    int *prev;
+    int *key;
+} SeedQueue;
+
+typedef struct {
+    double misfit;
+    double latitude;
+    double longitude;
+    double depth;
+    double origin;
+} LocatorBest;
+
+// One grid-search pass: picks in structure-of-arrays form plus the grid being scanned.
+// Each pool worker keeps its own best node and residual scratch.
+typedef struct {
+    const TravelTimeTable *table;
+    int pick_count;
+    double *x;
+    double *y;
+    double *z;
+    double *arrival;
+    double *weight;
+    double *residuals;
+    double weight_sum;
+    double latitude0;
+    double longitude0;
+    double step_deg;
+    double longitude_step_deg;
+    int latitude_nodes;
+    int longitude_nodes;
+    double depth0;
+    double depth_step;
+    int depth_nodes;
+    LocatorBest best[POOL_MAX_WORKERS];
+} LocatorJob;
+
 void initializeSeismicNetwork(SeismicNetwork *network);
+void freeSeismicNetwork(SeismicNetwork *network);
+int addSeismicStation(SeismicNetwork *network, int station_id, const char *location);
 void initializeStation(SeismicStation *station, int station_id, const char *location);
-void recordSeismicEvent(SeismicStation *station, SeismicEvent *event);
-void processSeismicData(SeismicStation *station);
+void recordSeismicEvent(SeismicNetwork *network, int station, SeismicEvent *event);
+void loadSeismicEvent(const SeismicEventTable *table, int row, SeismicEvent *event);
+bool indexStationEvents(SeismicNetwork *network);
+int findStationEventsInRange(SeismicNetwork *network, int station, int64_t from_ns, int64_t to_ns, int *first);
+int findNetworkEventsInRange(SeismicNetwork *network, int64_t from_ns, int64_t to_ns, int *first);
+void processSeismicData(SeismicNetwork *network, int station);
 void generateSeismicAlert(SeismicStation *station, SeismicEvent *event);
 void printSeismicEvent(SeismicEvent *event);
 void simulateSeismicActivity(SeismicNetwork *network);
 void printSeismicNetworkStatus(SeismicNetwork *network);
 void analyzeSeismicData(SeismicNetwork *network);
 void analyzeEventImpact(SeismicEvent *event);
-void resetStationData(SeismicStation *station);
-void printSeismicStationData(SeismicStation *station);
+void resetStationData(SeismicNetwork *network, int station);
+void printSeismicStationData(SeismicNetwork *network, int station);
 void resetNetwork(SeismicNetwork *network);
 void printSeismicAlert(SeismicEvent *event);
 void handleSeismicAlert(SeismicEvent *event);
 void simulateGlobalSeismicActivity(SeismicNetwork *network);
 void analyzeGlobalSeismicRisk(SeismicNetwork *network);
 void simulateEventBasedOnMagnitude(SeismicEvent *event);
+void appendReport(ReportBuffer *out, const char *format, ...);
+bool reserveReport(ReportBuffer *out, size_t extra);
+void appendBytes(ReportBuffer *out, const char *data, size_t length);
+void appendString(ReportBuffer *out, const char *text);
+void appendInteger(ReportBuffer *out, long long value);
+void appendFixed(ReportBuffer *out, float value, int decimals);
+void appendJsonString(ReportBuffer *out, const char *text);
+int eventImpactClass(const SeismicEvent *event);
+void formatReportRecord(ReportBuffer *out, ReportFormat format, const ReportRecord *record);
+bool openReportWriter(ReportWriter *writer, FILE *stream, ReportFormat format);
+void queueReportEvent(ReportWriter *writer, ReportRecordKind kind, const SeismicEvent *event);
+void queueReportStation(ReportWriter *writer, ReportRecordKind kind, const SeismicStation *station);
+void queueReportRisk(ReportWriter *writer, long total_events, long strong_events, const GutenbergRichterFit *fit);
+void queueReportSummary(ReportWriter *writer, long alerts, long events_analyzed, const long *impacts);
+void queueReportFormatted(ReportWriter *writer, const char *data, size_t length);
+bool parseReportFormat(const char *name, ReportFormat *format);
+void flushReportWriter(ReportWriter *writer);
+void closeReportWriter(ReportWriter *writer);
+void updateMagnitudeStats(MagnitudeStats *stats, float magnitude, int delta);
+void updateEventMagnitude(SeismicNetwork *network, int station, float latitude, float longitude, float magnitude, int delta);
+int magnitudeRegion(float latitude, float longitude);
+long countMagnitudesAtLeast(const MagnitudeStats *stats, float magnitude);
+bool fitGutenbergRichter(const MagnitudeStats *stats, GutenbergRichterFit *fit);
+double expectedEventsAtLeast(const GutenbergRichterFit *fit, double magnitude);
+void printGutenbergRichterFit(const char *label, const GutenbergRichterFit *fit);
+void runGutenbergRichterDemo(int station_count, int event_count);
+bool checkMagnitudeBins(void);
+int checkRangeQueries(SeismicNetwork *network, int trials);
+bool checkEventRanges(void);
+void formatSeismicEvent(ReportBuffer *out, const SeismicEvent *event);
+void formatSeismicAlert(ReportBuffer *out, const SeismicEvent *event);
+int formatEventImpact(ReportBuffer *out, const SeismicEvent *event);
+bool createStationPool(StationPool *pool, int worker_count);
+void destroyStationPool(StationPool *pool);
+void runStationPool(StationPool *pool, int station_count, StationTask task, void *context, StationOutput *station_output);
+void emitStationOutput(StationPool *pool, const StationOutput *station_output, int station_count, ReportWriter *writer);
+void simulateSeismicActivityParallel(SeismicNetwork *network, StationPool *pool);
+long processSeismicDataParallel(SeismicNetwork *network, StationPool *pool, StationOutput *station_output);
+long analyzeSeismicDataParallel(SeismicNetwork *network, StationPool *pool, StationOutput *station_output, long *impacts);
+void runParallelNetwork(int station_count, int worker_count, ReportFormat format);
+void measureParallelScaling(int station_count, int max_workers);
+int availableCores(void);
+double monotonicSeconds(void);
+int64_t civilTimestamp(int year, int month, int day, int hours, int minutes, int seconds);
+void formatEventTimestamp(int64_t timestamp_ns, char *date, char *time);
+void placeStationsOnSphere(SeismicNetwork *network);
+int collectDetections(SeismicNetwork *network, Detection **detections);
+bool associateDetections(SeismicNetwork *network, const TravelTimeTable *table, Detection *detections, int count,
+                         AssociationResult *result);
+void freeAssociationResult(AssociationResult *result);
+void printAssociatedEvents(SeismicNetwork *network, const AssociationResult *result, int limit);
+void runAssociationDemo(int station_count, int earthquake_count);
+double layeredTravelTime(double distance, double depth);
+bool buildTravelTimeTable(TravelTimeTable *table);
+void freeTravelTimeTable(TravelTimeTable *table);
+double lookupTravelTime(const TravelTimeTable *table, double chord, double depth);
+double hypocenterMisfit(const LocatorJob *job, const double *trial, double depth, double *residuals, double *origin);
+bool locateNetworkEvent(const TravelTimeTable *table, SeismicNetwork *network, AssociationResult *result, int e, StationPool *pool);
+int compareDoubles(const void *a, const void *b);
+
+// Layered P-wave model, close to continental ak135 down to 700 km.
+const VelocityLayer velocityModel[] = {
+    {0.0, 5.80}, {20.0, 6.50}, {35.0, 8.04}, {120.0, 8.05}, {210.0, 8.30}, {410.0, 9.36}, {660.0, 10.20},
+};
+#define VELOCITY_LAYERS ((int)(sizeof(velocityModel) / sizeof(velocityModel[0])))
+
+ReportWriter reportWriter;
 
-int main(void) {
+int main(int argc, char **argv) {
     SeismicNetwork network;
+    ReportFormat format = REPORT_TEXT;
+    int arg = 1;
+    if (argc > 1 && strcmp(argv[1], "--format") == 0) {
+        if (argc < 3 || !parseReportFormat(argv[2], &format)) {
+            fprintf(stderr, "Usage: %s [--format text|jsonl|binary] [--parallel [stations [workers]]]\n", argv[0]);
+            return 1;
+        }
+        arg = 3;
+    }
+    if (argc > arg && strcmp(argv[arg], "--parallel") == 0) {
+        runParallelNetwork(argc > arg + 1 ? atoi(argv[arg + 1]) : MAX_STATIONS,
+                           argc > arg + 2 ? atoi(argv[arg + 2]) : availableCores(), format);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--associate") == 0) {
+        runAssociationDemo(argc > 2 ? atoi(argv[2]) : SCALING_STATIONS, argc > 3 ? atoi(argv[3]) : 200);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--gutenberg") == 0) {
+        runGutenbergRichterDemo(argc > 2 ? atoi(argv[2]) : SCALING_STATIONS, argc > 3 ? atoi(argv[3]) : 1000000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--check-gutenberg") == 0) {
+        return checkMagnitudeBins() ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "--check-ranges") == 0) {
+        return checkEventRanges() ? 0 : 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "--scaling") == 0) {
+        measureParallelScaling(argc > 2 ? atoi(argv[2]) : SCALING_STATIONS, argc > 3 ? atoi(argv[3]) : availableCores());
+        return 0;
+    }
+
+    if (!openReportWriter(&reportWriter, stdout, format)) {
+        return 1;
+    }
     initializeSeismicNetwork(&network);
 
     simulateSeismicActivity(&network);
@@ -57,36 +509,300 @@ int main(void) {
     analyzeSeismicData(&network);
     analyzeGlobalSeismicRisk(&network);
 
+    closeReportWriter(&reportWriter);
+    freeSeismicNetwork(&network);
     return 0;
 }
 
 void initializeSeismicNetwork(SeismicNetwork *network) {
-    network->station_count = MAX_STATIONS;
-    for (int i = 0; i < network->station_count; i++) {
+    memset(network, 0, sizeof(*network));
+    for (int i = 0; i < MAX_STATIONS; i++) {
         char location[50];
         sprintf(location, "Station %d Location", i + 1);
-        initializeStation(&network->stations[i], i + 1, location);
+        addSeismicStation(network, i + 1, location);
+    }
+}
+
+void freeSeismicNetwork(SeismicNetwork *network) {
+    SeismicEventTable *table = &network->events;
+    free(table->station);
+    free(table->timestamp_ns);
+    free(table->latitude);
+    free(table->longitude);
+    free(table->depth);
+    free(table->magnitude);
+    free(table->event_detected);
+    free(table->station_offsets);
+    free(table->station_rows);
+    free(table->time_rows);
+    free(network->stations);
+    memset(network, 0, sizeof(*network));
+}
+
+// Returns the new station's index, or -1 if the station table could not grow.
+int addSeismicStation(SeismicNetwork *network, int station_id, const char *location) {
+    if (network->station_count == network->station_capacity) {
+        int capacity = network->station_capacity ? network->station_capacity * 2 : INITIAL_STATION_CAPACITY;
+        SeismicStation *stations = realloc(network->stations, capacity * sizeof(SeismicStation));
+        if (stations == NULL) {
+            printf("Error: unable to add station %d.\n", station_id);
+            return -1;
+        }
+        network->stations = stations;
+        network->station_capacity = capacity;
     }
+    initializeStation(&network->stations[network->station_count], station_id, location);
+    return network->station_count++;
 }
 
 void initializeStation(SeismicStation *station, int station_id, const char *location) {
     station->station_id = station_id;
-    strcpy(station->location, location);
+    snprintf(station->location, sizeof(station->location), "%s", location);
+    station->latitude = 0;
+    station->longitude = 0;
     station->event_count = 0;
+    memset(&station->magnitudes, 0, sizeof(station->magnitudes));
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date, and the inverse below; both are
+// pure arithmetic, so no locale or time zone state is involved.
+int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int year_of_era = (int)(year - era * 400);
+    int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+void civilFromDays(int64_t days, int *year, int *month, int *day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int day_of_era = (int)(days - era * 146097);
+    int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    int day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    int month_index = (5 * day_of_year + 2) / 153;
+    *day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    *month = month_index < 10 ? month_index + 3 : month_index - 9;
+    *year = (int)(year_of_era + era * 400) + (*month <= 2);
+}
+
+int64_t civilTimestamp(int year, int month, int day, int hours, int minutes, int seconds) {
+    return (daysFromCivil(year, month, day) * 86400 + hours * 3600 + minutes * 60 + seconds) * NS_PER_SECOND;
+}
+
+bool growEventTable(SeismicEventTable *table) {
+    int capacity = table->capacity ? table->capacity * 2 : INITIAL_EVENT_CAPACITY;
+    void *column;
+
+    if ((column = realloc(table->station, capacity * sizeof(int))) == NULL) return false;
+    table->station = column;
+    if ((column = realloc(table->timestamp_ns, capacity * sizeof(int64_t))) == NULL) return false;
+    table->timestamp_ns = column;
+    if ((column = realloc(table->latitude, capacity * sizeof(float))) == NULL) return false;
+    table->latitude = column;
+    if ((column = realloc(table->longitude, capacity * sizeof(float))) == NULL) return false;
+    table->longitude = column;
+    if ((column = realloc(table->depth, capacity * sizeof(float))) == NULL) return false;
+    table->depth = column;
+    if ((column = realloc(table->magnitude, capacity * sizeof(float))) == NULL) return false;
+    table->magnitude = column;
+    if ((column = realloc(table->event_detected, capacity * sizeof(bool))) == NULL) return false;
+    table->event_detected = column;
+    table->capacity = capacity;
+    return true;
+}
+
+void recordSeismicEvent(SeismicNetwork *network, int station, SeismicEvent *event) {
+    SeismicEventTable *table = &network->events;
+    if (table->count == table->capacity && !growEventTable(table)) {
+        printf("Error: event table full, dropping event for station %d.\n", network->stations[station].station_id);
+        return;
+    }
+    int row = table->count++;
+    table->station[row] = station;
+    table->timestamp_ns[row] = event->timestamp_ns;
+    table->latitude[row] = event->latitude;
+    table->longitude[row] = event->longitude;
+    table->depth[row] = event->depth;
+    table->magnitude[row] = event->magnitude;
+    table->event_detected[row] = event->event_detected;
+    network->stations[station].event_count++;
+    updateEventMagnitude(network, station, event->latitude, event->longitude, event->magnitude, 1);
+}
+
+void putDigits(char *text, int value, int width) {
+    for (int i = width - 1; i >= 0; i--) {
+        text[i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+// Writes "YYYY-MM-DD" into date[11] and "HH:MM:SS" into time[9]; sub-second digits are
+// truncated. Years outside 0..9999 are written by snprintf and cut to ten characters.
+void formatEventTimestamp(int64_t timestamp_ns, char *date, char *time) {
+    int64_t epoch = (timestamp_ns >= 0 ? timestamp_ns : timestamp_ns - (NS_PER_SECOND - 1)) / NS_PER_SECOND;
+    int64_t days = (epoch >= 0 ? epoch : epoch - 86399) / 86400;
+    int seconds_of_day = (int)(epoch - days * 86400);
+    int year, month, day;
+    civilFromDays(days, &year, &month, &day);
+
+    if (year >= 0 && year <= 9999) {
+        putDigits(date, year, 4);
+        date[4] = '-';
+        putDigits(date + 5, month, 2);
+        date[7] = '-';
+        putDigits(date + 8, day, 2);
+    } else {
+        char text[32];
+        snprintf(text, sizeof(text), "%04d-%02d-%02d", year, month, day);
+        memcpy(date, text, 10);
+    }
+    date[10] = '\0';
+    putDigits(time, seconds_of_day / 3600, 2);
+    time[2] = ':';
+    putDigits(time + 3, seconds_of_day / 60 % 60, 2);
+    time[5] = ':';
+    putDigits(time + 6, seconds_of_day % 60, 2);
+    time[8] = '\0';
+}
+
+void loadSeismicEvent(const SeismicEventTable *table, int row, SeismicEvent *event) {
+    event->latitude = table->latitude[row];
+    event->longitude = table->longitude[row];
+    event->depth = table->depth[row];
+    event->magnitude = table->magnitude[row];
+    event->timestamp_ns = table->timestamp_ns[row];
+    event->event_detected = table->event_detected[row];
+}
+
+int compareEventTimeKeys(const void *a, const void *b) {
+    const EventTimeKey *left = a, *right = b;
+    if (left->timestamp_ns != right->timestamp_ns) {
+        return left->timestamp_ns < right->timestamp_ns ? -1 : 1;
+    }
+    return left->row - right->row;
+}
+
+// Orders all rows by time into time_rows, skipping the sort when rows were appended in
+// time order, then counting-sorts that order by station. The counting sort is stable, so
+// each station's rows come out time-ordered too.
+bool indexStationEvents(SeismicNetwork *network) {
+    SeismicEventTable *table = &network->events;
+    if (table->indexed_count == table->count && table->indexed_stations == network->station_count &&
+        table->station_offsets != NULL) {
+        return true;
+    }
+    int *offsets = realloc(table->station_offsets, (network->station_count + 1) * sizeof(int));
+    if (offsets == NULL) {
+        printf("Error: unable to index station events.\n");
+        return false;
+    }
+    table->station_offsets = offsets;
+    int *rows = realloc(table->station_rows, (table->count + 1) * sizeof(int));
+    if (rows == NULL) {
+        printf("Error: unable to index station events.\n");
+        return false;
+    }
+    table->station_rows = rows;
+    int *time_rows = realloc(table->time_rows, (table->count + 1) * sizeof(int));
+    if (time_rows == NULL) {
+        printf("Error: unable to index station events.\n");
+        return false;
+    }
+    table->time_rows = time_rows;
+
+    bool ordered = true;
+    for (int row = 1; row < table->count && ordered; row++) {
+        ordered = table->timestamp_ns[row - 1] <= table->timestamp_ns[row];
+    }
+    if (ordered) {
+        for (int row = 0; row < table->count; row++) {
+            time_rows[row] = row;
+        }
+    } else {
+        EventTimeKey *keys = malloc(table->count * sizeof(EventTimeKey));
+        if (keys == NULL) {
+            printf("Error: unable to index station events.\n");
+            return false;
+        }
+        for (int row = 0; row < table->count; row++) {
+            keys[row].timestamp_ns = table->timestamp_ns[row];
+            keys[row].row = row;
+        }
+        qsort(keys, table->count, sizeof(EventTimeKey), compareEventTimeKeys);
+        for (int i = 0; i < table->count; i++) {
+            time_rows[i] = keys[i].row;
+        }
+        free(keys);
+    }
+
+    offsets[0] = 0;
+    for (int s = 0; s < network->station_count; s++) {
+        offsets[s + 1] = offsets[s] + network->stations[s].event_count;
+    }
+    for (int s = network->station_count; s > 0; s--) {
+        offsets[s] = offsets[s - 1];
+    }
+    for (int i = 0; i < table->count; i++) {
+        int row = time_rows[i];
+        rows[offsets[table->station[row] + 1]++] = row;
+    }
+    table->indexed_count = table->count;
+    table->indexed_stations = network->station_count;
+    return true;
 }
 
-void recordSeismicEvent(SeismicStation *station, SeismicEvent *event) {
-    if (station->event_count < MAX_EVENT_RECORDS) {
-        station->events[station->event_count] = *event;
-        station->event_count++;
+// First position in rows[begin .. end), a time-ordered list of rows, whose timestamp is
+// not before timestamp_ns.
+int lowerBoundEventTime(const SeismicEventTable *table, const int *rows, int begin, int end, int64_t timestamp_ns) {
+    while (begin < end) {
+        int middle = begin + (end - begin) / 2;
+        if (table->timestamp_ns[rows[middle]] < timestamp_ns) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+    return begin;
+}
+
+// The station's rows with from_ns <= timestamp < to_ns are station_rows[*first ..
+// *first + count), where count is the return value.
+int findStationEventsInRange(SeismicNetwork *network, int station, int64_t from_ns, int64_t to_ns, int *first) {
+    SeismicEventTable *table = &network->events;
+    *first = 0;
+    if (!indexStationEvents(network)) {
+        return 0;
     }
+    int end = table->station_offsets[station + 1];
+    *first = lowerBoundEventTime(table, table->station_rows, table->station_offsets[station], end, from_ns);
+    return lowerBoundEventTime(table, table->station_rows, *first, end, to_ns) - *first;
 }
 
-void processSeismicData(SeismicStation *station) {
-    for (int i = 0; i < station->event_count; i++) {
-        SeismicEvent *event = &station->events[i];
-        if (event->event_detected) {
-            generateSeismicAlert(station, event);
+// As findStationEventsInRange, over the whole network: the rows are time_rows[*first ..
+// *first + count).
+int findNetworkEventsInRange(SeismicNetwork *network, int64_t from_ns, int64_t to_ns, int *first) {
+    SeismicEventTable *table = &network->events;
+    *first = 0;
+    if (!indexStationEvents(network)) {
+        return 0;
+    }
+    *first = lowerBoundEventTime(table, table->time_rows, 0, table->count, from_ns);
+    return lowerBoundEventTime(table, table->time_rows, *first, table->count, to_ns) - *first;
+}
+
+void processSeismicData(SeismicNetwork *network, int station) {
+    SeismicEventTable *table = &network->events;
+    if (!indexStationEvents(network)) {
+        return;
+    }
+    for (int i = table->station_offsets[station]; i < table->station_offsets[station + 1]; i++) {
+        int row = table->station_rows[i];
+        if (table->event_detected[row]) {
+            SeismicEvent event;
+            loadSeismicEvent(table, row, &event);
+            generateSeismicAlert(&network->stations[station], &event);
         }
     }
 }
@@ -98,12 +814,7 @@ void generateSeismicAlert(SeismicStation *station, SeismicEvent *event) {
 }
 
 void printSeismicEvent(SeismicEvent *event) {
-    printf("Event Date: %s\n", event->date);
-    printf("Event Time: %s\n", event->time);
-    printf("Location: Lat: %.2f, Long: %.2f, Depth: %.2f km\n", event->latitude, event->longitude, event->depth);
-    printf("Magnitude: %.2f\n", event->magnitude);
-    printf("Event Detected: %s\n", event->event_detected ? "YES" : "NO");
-    printf("global network\n");
+    queueReportEvent(&reportWriter, REPORT_EVENT, event);
 }
 
 void simulateSeismicActivity(SeismicNetwork *network) {
@@ -114,71 +825,91 @@ void simulateSeismicActivity(SeismicNetwork *network) {
             event.longitude = (rand() % 360) - 180; 
             event.depth = rand() % 700;  
             event.magnitude = (rand() % 10) + 4;  
-            snprintf(event.date, sizeof(event.date), "2025-03-%02d", j + 1);
-            snprintf(event.time, sizeof(event.time), "12:00:%02d", j * 5);
+            event.timestamp_ns = civilTimestamp(2025, 3, j + 1, 12, 0, j * 5);
             event.event_detected = (rand() % 2) == 0 ? true : false;  
 
-            recordSeismicEvent(&network->stations[i], &event);
+            recordSeismicEvent(network, i, &event);
         }
-        processSeismicData(&network->stations[i]);
+    }
+    // Recording prints nothing, so processing after the whole batch keeps the output order
+    // while the station index is built once rather than per station.
+    for (int i = 0; i < network->station_count; i++) {
+        processSeismicData(network, i);
     }
 }
 
 void printSeismicNetworkStatus(SeismicNetwork *network) {
     for (int i = 0; i < network->station_count; i++) {
-        printf("Seismic Station ID: %d\n", network->stations[i].station_id);
-        printSeismicStationData(&network->stations[i]);
+        queueReportStation(&reportWriter, REPORT_STATION_ID, &network->stations[i]);
+        printSeismicStationData(network, i);
     }
 }
 
 void analyzeSeismicData(SeismicNetwork *network) {
-    for (int i = 0; i < network->station_count; i++) {
-        SeismicStation *station = &network->stations[i];
-        for (int j = 0; j < station->event_count; j++) {
-            SeismicEvent *event = &station->events[j];
-            analyzeEventImpact(event);
-        }
+    SeismicEventTable *table = &network->events;
+    if (!indexStationEvents(network)) {
+        return;
+    }
+    for (int i = 0; i < table->indexed_count; i++) {
+        SeismicEvent event;
+        loadSeismicEvent(table, table->station_rows[i], &event);
+        analyzeEventImpact(&event);
     }
 }
 
 void analyzeEventImpact(SeismicEvent *event) {
-    if (event->magnitude >= 7.0) {
-        printf("High Impact Event Detected!\n");
-        printSeismicEvent(event);
-    } else if (event->magnitude >= 5.0) {
-        printf("Moderate Impact Event Detected.\n");
-        printSeismicEvent(event);
-    } else {
-        printf("Low Impact Event.\n");
-        printSeismicEvent(event);
-    }
+    queueReportEvent(&reportWriter, REPORT_IMPACT, event);
 }
 
-void resetStationData(SeismicStation *station) {
-    station->event_count = 0;
+// Drops one station's rows by compacting every column in place.
+void resetStationData(SeismicNetwork *network, int station) {
+    SeismicEventTable *table = &network->events;
+    int kept = 0;
+    for (int row = 0; row < table->count; row++) {
+        if (table->station[row] == station) {
+            updateEventMagnitude(network, station, table->latitude[row], table->longitude[row], table->magnitude[row], -1);
+            continue;
+        }
+        table->station[kept] = table->station[row];
+        table->timestamp_ns[kept] = table->timestamp_ns[row];
+        table->latitude[kept] = table->latitude[row];
+        table->longitude[kept] = table->longitude[row];
+        table->depth[kept] = table->depth[row];
+        table->magnitude[kept] = table->magnitude[row];
+        table->event_detected[kept] = table->event_detected[row];
+        kept++;
+    }
+    table->count = kept;
+    table->indexed_count = -1;
+    network->stations[station].event_count = 0;
 }
 
-void printSeismicStationData(SeismicStation *station) {
-    printf("Station Location: %s\n", station->location);
-    printf("Total Events Recorded: %d\n", station->event_count);
-    printf("---- Event Details ----\n");
-    for (int i = 0; i < station->event_count; i++) {
-        printSeismicEvent(&station->events[i]);
+void printSeismicStationData(SeismicNetwork *network, int station) {
+    SeismicEventTable *table = &network->events;
+    if (!indexStationEvents(network)) {
+        return;
+    }
+    queueReportStation(&reportWriter, REPORT_STATION, &network->stations[station]);
+    for (int i = table->station_offsets[station]; i < table->station_offsets[station + 1]; i++) {
+        SeismicEvent event;
+        loadSeismicEvent(table, table->station_rows[i], &event);
+        printSeismicEvent(&event);
     }
 }
 
 void resetNetwork(SeismicNetwork *network) {
     for (int i = 0; i < network->station_count; i++) {
-        resetStationData(&network->stations[i]);
+        network->stations[i].event_count = 0;
+        memset(&network->stations[i].magnitudes, 0, sizeof(network->stations[i].magnitudes));
     }
+    memset(&network->magnitudes, 0, sizeof(network->magnitudes));
+    memset(network->region_magnitudes, 0, sizeof(network->region_magnitudes));
+    network->events.count = 0;
+    network->events.indexed_count = -1;
 }
 
 void printSeismicAlert(SeismicEvent *event) {
-    printf("ALERT: Seismic Event Detected!\n");
-    printf("Location: Lat: %.2f, Long: %.2f, Depth: %.2f km\n", event->latitude, event->longitude, event->depth);
-    printf("Magnitude: %.2f\n", event->magnitude);
-    printf("Time: %s, Date: %s\n", event->time, event->date);
-    printf("---- ALERT ----\n");
+    queueReportEvent(&reportWriter, REPORT_ALERT, event);
 }
 
 void handleSeismicAlert(SeismicEvent *event) {
@@ -193,17 +924,11 @@ void simulateGlobalSeismicActivity(SeismicNetwork *network) {
     }
 }
 
+// Reads the incrementally maintained statistics; nothing here scans the event table.
 void analyzeGlobalSeismicRisk(SeismicNetwork *network) {
-    int total_events = 0;
-    for (int i = 0; i < network->station_count; i++) {
-        total_events += network->stations[i].event_count;
-    }
-    printf("Total Seismic Events in Network: %d\n", total_events);
-    if (total_events > 50) {
-        printf("High Seismic Risk Across Network!\n");
-    } else {
-        printf("Seismic Activity is within Normal Range.\n");
-    }
+    GutenbergRichterFit fit;
+    fitGutenbergRichter(&network->magnitudes, &fit);
+    queueReportRisk(&reportWriter, network->magnitudes.count, countMagnitudesAtLeast(&network->magnitudes, 6.0f), &fit);
 }
 
 void simulateEventBasedOnMagnitude(SeismicEvent *event) {
@@ -211,7 +936,2244 @@ void simulateEventBasedOnMagnitude(SeismicEvent *event) {
     event->latitude = (rand() % 180) - 90;
     event->longitude = (rand() % 360) - 180;
     event->depth = rand() % 700;
-    snprintf(event->date, sizeof(event->date), "2025-03-01");
-    snprintf(event->time, sizeof(event->time), "14:00:00");
+    event->timestamp_ns = civilTimestamp(2025, 3, 1, 14, 0, 0);
     event->event_detected = (rand() % 2) == 0;
 }
+
+bool reserveReport(ReportBuffer *out, size_t extra) {
+    if (out->length + extra <= out->capacity) {
+        return true;
+    }
+    size_t capacity = out->capacity ? out->capacity * 2 : 4096;
+    while (capacity < out->length + extra) {
+        capacity *= 2;
+    }
+    char *data = realloc(out->data, capacity);
+    if (data == NULL) {
+        return false;
+    }
+    out->data = data;
+    out->capacity = capacity;
+    return true;
+}
+
+void appendReport(ReportBuffer *out, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    if (out->stream != NULL) {
+        vfprintf(out->stream, format, args);
+        va_end(args);
+        return;
+    }
+    size_t available = out->capacity - out->length;
+    int written = vsnprintf(out->data ? out->data + out->length : NULL, available, format, args);
+    va_end(args);
+    if (written < 0) {
+        return;
+    }
+    if ((size_t)written >= available) {
+        if (!reserveReport(out, (size_t)written + 1)) {
+            return;
+        }
+        va_start(args, format);
+        vsnprintf(out->data + out->length, out->capacity - out->length, format, args);
+        va_end(args);
+    }
+    out->length += (size_t)written;
+}
+
+void appendBytes(ReportBuffer *out, const char *data, size_t length) {
+    if (out->stream != NULL) {
+        fwrite(data, 1, length, out->stream);
+        return;
+    }
+    if (!reserveReport(out, length)) {
+        return;
+    }
+    memcpy(out->data + out->length, data, length);
+    out->length += length;
+}
+
+void appendString(ReportBuffer *out, const char *text) {
+    appendBytes(out, text, strlen(text));
+}
+
+void appendInteger(ReportBuffer *out, long long value) {
+    char reversed[24], text[24];
+    unsigned long long magnitude = value < 0 ? 0 - (unsigned long long)value : (unsigned long long)value;
+    int n = 0, length = 0;
+    do {
+        reversed[n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        text[length++] = '-';
+    }
+    while (n > 0) {
+        text[length++] = reversed[--n];
+    }
+    appendBytes(out, text, length);
+}
+
+// Same text as printf("%.*f", decimals, value). A float times 10^3 is exact in a double,
+// so rounding the scaled value with nearbyint (ties to even, as printf does) gives the
+// correctly rounded digits; very large or non-finite values go through snprintf.
+void appendFixed(ReportBuffer *out, float value, int decimals) {
+    static const double scales[] = {1, 10, 100, 1000};
+    char text[64];
+    double scaled = decimals >= 0 && decimals <= 3 ? (double)value * scales[decimals] : INFINITY;
+    if (!(fabs(scaled) < 1e15)) {
+        int length = snprintf(text, sizeof(text), "%.*f", decimals, value);
+        appendBytes(out, text, length < (int)sizeof(text) ? (size_t)length : sizeof(text) - 1);
+        return;
+    }
+    uint64_t digits = (uint64_t)nearbyint(fabs(scaled));
+    char reversed[24];
+    int n = 0, length = 0;
+    do {
+        reversed[n++] = (char)('0' + digits % 10);
+        digits /= 10;
+    } while (digits > 0 || n <= decimals);
+    if (signbit(value)) {
+        text[length++] = '-';
+    }
+    while (n > 0) {
+        text[length++] = reversed[--n];
+        if (n == decimals && decimals > 0) {
+            text[length++] = '.';
+        }
+    }
+    appendBytes(out, text, length);
+}
+
+void appendJsonString(ReportBuffer *out, const char *text) {
+    appendBytes(out, "\"", 1);
+    for (const char *run = text; *text != '\0'; run = text) {
+        while (*text != '\0' && *text != '"' && *text != '\\' && (unsigned char)*text >= 0x20) {
+            text++;
+        }
+        appendBytes(out, run, text - run);
+        if (*text == '"' || *text == '\\') {
+            char escaped[2] = {'\\', *text++};
+            appendBytes(out, escaped, 2);
+        } else if (*text != '\0') {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)*text++);
+            appendBytes(out, escaped, 6);
+        }
+    }
+    appendBytes(out, "\"", 1);
+}
+
+void formatSeismicEvent(ReportBuffer *out, const SeismicEvent *event) {
+    char date[11], time[9];
+    formatEventTimestamp(event->timestamp_ns, date, time);
+    appendString(out, "Event Date: ");
+    appendBytes(out, date, 10);
+    appendString(out, "\nEvent Time: ");
+    appendBytes(out, time, 8);
+    appendString(out, "\nLocation: Lat: ");
+    appendFixed(out, event->latitude, 2);
+    appendString(out, ", Long: ");
+    appendFixed(out, event->longitude, 2);
+    appendString(out, ", Depth: ");
+    appendFixed(out, event->depth, 2);
+    appendString(out, " km\nMagnitude: ");
+    appendFixed(out, event->magnitude, 2);
+    appendString(out, event->event_detected ? "\nEvent Detected: YES\nglobal network\n" : "\nEvent Detected: NO\nglobal network\n");
+}
+
+void formatSeismicAlert(ReportBuffer *out, const SeismicEvent *event) {
+    char date[11], time[9];
+    formatEventTimestamp(event->timestamp_ns, date, time);
+    appendString(out, "ALERT: Seismic Event Detected!\nLocation: Lat: ");
+    appendFixed(out, event->latitude, 2);
+    appendString(out, ", Long: ");
+    appendFixed(out, event->longitude, 2);
+    appendString(out, ", Depth: ");
+    appendFixed(out, event->depth, 2);
+    appendString(out, " km\nMagnitude: ");
+    appendFixed(out, event->magnitude, 2);
+    appendString(out, "\nTime: ");
+    appendBytes(out, time, 8);
+    appendString(out, ", Date: ");
+    appendBytes(out, date, 10);
+    appendString(out, "\n---- ALERT ----\n");
+}
+
+// Returns the impact class: 2 high, 1 moderate, 0 low.
+int eventImpactClass(const SeismicEvent *event) {
+    return event->magnitude >= 7.0 ? 2 : (event->magnitude >= 5.0 ? 1 : 0);
+}
+
+// Returns the impact class, as eventImpactClass.
+int formatEventImpact(ReportBuffer *out, const SeismicEvent *event) {
+    static const char *const headlines[] = {
+        "Low Impact Event.\n", "Moderate Impact Event Detected.\n", "High Impact Event Detected!\n",
+    };
+    int impact = eventImpactClass(event);
+    appendString(out, headlines[impact]);
+    formatSeismicEvent(out, event);
+    return impact;
+}
+
+void formatJsonNumber(ReportBuffer *out, const char *key, float value, int decimals) {
+    appendString(out, key);
+    if (isfinite(value)) {
+        appendFixed(out, value, decimals);
+    } else {
+        appendString(out, "null");
+    }
+}
+
+void formatEventJson(ReportBuffer *out, const char *type, const SeismicEvent *event) {
+    char date[11], time[9];
+    formatEventTimestamp(event->timestamp_ns, date, time);
+    appendString(out, "{\"type\":\"");
+    appendString(out, type);
+    appendString(out, "\",\"timestamp_ns\":");
+    appendInteger(out, event->timestamp_ns);
+    appendString(out, ",\"time\":\"");
+    appendBytes(out, date, 10);
+    appendBytes(out, "T", 1);
+    appendBytes(out, time, 8);
+    appendString(out, "Z\"");
+    formatJsonNumber(out, ",\"latitude\":", event->latitude, 2);
+    formatJsonNumber(out, ",\"longitude\":", event->longitude, 2);
+    formatJsonNumber(out, ",\"depth_km\":", event->depth, 2);
+    formatJsonNumber(out, ",\"magnitude\":", event->magnitude, 2);
+    appendString(out, event->event_detected ? ",\"detected\":true" : ",\"detected\":false");
+}
+
+// Binary records are a one-byte kind followed by the fields below, unpadded and in host
+// byte order: station ids and counts as int32, timestamps and totals as int64, locations
+// as 50 bytes, event coordinates as four float32 and detection as one byte. Risk records
+// end with b, its 95% bounds, a and its error as float32, NaN when there is no fit.
+// Summary records are five int64 totals: alerts, events analyzed, then low, moderate
+// and high impact events.
+void formatReportRecord(ReportBuffer *out, ReportFormat format, const ReportRecord *record) {
+    static const char *const impacts[] = {"low", "moderate", "high"};
+    const SeismicEvent *event = &record->event;
+
+    if (record->kind == REPORT_FORMATTED) {
+        appendBytes(out, record->formatted.data, record->formatted.length);
+        return;
+    }
+    if (format == REPORT_BINARY) {
+        uint8_t kind = (uint8_t)record->kind;
+        appendBytes(out, (const char *)&kind, 1);
+        if (record->kind == REPORT_STATION_ID || record->kind == REPORT_STATION) {
+            int32_t station_id = record->station.station_id, event_count = record->station.event_count;
+            appendBytes(out, (const char *)&station_id, sizeof(station_id));
+            if (record->kind == REPORT_STATION) {
+                appendBytes(out, (const char *)&event_count, sizeof(event_count));
+                appendBytes(out, record->station.location, sizeof(record->station.location));
+            }
+        } else if (record->kind == REPORT_RISK) {
+            const GutenbergRichterFit *fit = &record->risk.fit;
+            int64_t totals[2] = {record->risk.total_events, record->risk.strong_events};
+            float values[5] = {fit->b_value, fit->b_lower, fit->b_upper, fit->a_value, fit->a_error};
+            for (int i = 0; i < 5 && !fit->valid; i++) {
+                values[i] = NAN;
+            }
+            appendBytes(out, (const char *)totals, sizeof(totals));
+            appendBytes(out, (const char *)values, sizeof(values));
+        } else if (record->kind == REPORT_SUMMARY) {
+            int64_t totals[5] = {record->summary.alerts, record->summary.events_analyzed, record->summary.impacts[0],
+                                 record->summary.impacts[1], record->summary.impacts[2]};
+            appendBytes(out, (const char *)totals, sizeof(totals));
+        } else {
+            float fields[4] = {event->latitude, event->longitude, event->depth, event->magnitude};
+            uint8_t detected = event->event_detected;
+            appendBytes(out, (const char *)&event->timestamp_ns, sizeof(event->timestamp_ns));
+            appendBytes(out, (const char *)fields, sizeof(fields));
+            appendBytes(out, (const char *)&detected, 1);
+        }
+        return;
+    }
+
+    switch (record->kind) {
+    case REPORT_FORMATTED:
+        break;
+    case REPORT_STATION_ID:
+        if (format == REPORT_JSONL) {
+            appendString(out, "{\"type\":\"station\",\"station_id\":");
+            appendInteger(out, record->station.station_id);
+            appendString(out, "}\n");
+        } else {
+            appendString(out, "Seismic Station ID: ");
+            appendInteger(out, record->station.station_id);
+            appendBytes(out, "\n", 1);
+        }
+        break;
+    case REPORT_STATION:
+        if (format == REPORT_JSONL) {
+            appendString(out, "{\"type\":\"station_events\",\"station_id\":");
+            appendInteger(out, record->station.station_id);
+            appendString(out, ",\"location\":");
+            appendJsonString(out, record->station.location);
+            appendString(out, ",\"event_count\":");
+            appendInteger(out, record->station.event_count);
+            appendString(out, "}\n");
+        } else {
+            appendString(out, "Station Location: ");
+            appendString(out, record->station.location);
+            appendString(out, "\nTotal Events Recorded: ");
+            appendInteger(out, record->station.event_count);
+            appendString(out, "\n---- Event Details ----\n");
+        }
+        break;
+    case REPORT_EVENT:
+    case REPORT_ALERT:
+        if (format == REPORT_JSONL) {
+            formatEventJson(out, record->kind == REPORT_EVENT ? "event" : "alert", event);
+            appendString(out, "}\n");
+        } else if (record->kind == REPORT_EVENT) {
+            formatSeismicEvent(out, event);
+        } else {
+            formatSeismicAlert(out, event);
+        }
+        break;
+    case REPORT_IMPACT:
+        if (format == REPORT_JSONL) {
+            formatEventJson(out, "impact", event);
+            appendString(out, ",\"impact\":\"");
+            appendString(out, impacts[eventImpactClass(event)]);
+            appendString(out, "\"}\n");
+        } else {
+            formatEventImpact(out, event);
+        }
+        break;
+    case REPORT_RISK:
+        if (format == REPORT_JSONL) {
+            const GutenbergRichterFit *fit = &record->risk.fit;
+            appendString(out, "{\"type\":\"risk\",\"total_events\":");
+            appendInteger(out, record->risk.total_events);
+            appendString(out, ",\"strong_events\":");
+            appendInteger(out, record->risk.strong_events);
+            appendString(out, record->risk.total_events > 50 ? ",\"high_risk\":true" : ",\"high_risk\":false");
+            if (fit->valid) {
+                formatJsonNumber(out, ",\"b_value\":", fit->b_value, 3);
+                formatJsonNumber(out, ",\"b_lower\":", fit->b_lower, 3);
+                formatJsonNumber(out, ",\"b_upper\":", fit->b_upper, 3);
+                formatJsonNumber(out, ",\"a_value\":", fit->a_value, 2);
+                formatJsonNumber(out, ",\"a_error\":", fit->a_error, 2);
+            }
+            appendString(out, "}\n");
+        } else {
+            const GutenbergRichterFit *fit = &record->risk.fit;
+            appendString(out, "Total Seismic Events in Network: ");
+            appendInteger(out, record->risk.total_events);
+            appendString(out, "\nEvents of Magnitude 6.0 or Greater: ");
+            appendInteger(out, record->risk.strong_events);
+            appendString(out, record->risk.total_events > 50 ? "\nHigh Seismic Risk Across Network!\n"
+                                                             : "\nSeismic Activity is within Normal Range.\n");
+            if (fit->valid) {
+                appendString(out, "Gutenberg-Richter fit: b = ");
+                appendFixed(out, fit->b_value, 3);
+                appendString(out, " [");
+                appendFixed(out, fit->b_lower, 3);
+                appendString(out, ", ");
+                appendFixed(out, fit->b_upper, 3);
+                appendString(out, "], a = ");
+                appendFixed(out, fit->a_value, 2);
+                appendString(out, " +/- ");
+                appendFixed(out, fit->a_error, 2);
+                appendString(out, " (");
+                appendInteger(out, fit->count);
+                appendString(out, " events >= M ");
+                appendFixed(out, fit->completeness, 1);
+                appendString(out, ")\n");
+            }
+        }
+        break;
+    case REPORT_SUMMARY:
+        if (format == REPORT_JSONL) {
+            appendString(out, "{\"type\":\"summary\",\"alerts\":");
+            appendInteger(out, record->summary.alerts);
+            appendString(out, ",\"events_analyzed\":");
+            appendInteger(out, record->summary.events_analyzed);
+            for (int i = 2; i >= 0; i--) {
+                appendString(out, ",\"");
+                appendString(out, impacts[i]);
+                appendString(out, "_impact\":");
+                appendInteger(out, record->summary.impacts[i]);
+            }
+            appendString(out, "}\n");
+        } else {
+            appendString(out, "Alerts Issued: ");
+            appendInteger(out, record->summary.alerts);
+            appendString(out, "\nEvents Analyzed: ");
+            appendInteger(out, record->summary.events_analyzed);
+            appendString(out, " (");
+            appendInteger(out, record->summary.impacts[2]);
+            appendString(out, " high, ");
+            appendInteger(out, record->summary.impacts[1]);
+            appendString(out, " moderate, ");
+            appendInteger(out, record->summary.impacts[0]);
+            appendString(out, " low impact)\n");
+        }
+        break;
+    }
+}
+
+void writeReportBatch(ReportWriter *writer, ReportBatch *batch) {
+    for (int r = 0; r < batch->count; r++) {
+        formatReportRecord(&writer->text, writer->format, &batch->records[r]);
+    }
+    if (writer->text.length > 0) {
+        fwrite(writer->text.data, 1, writer->text.length, writer->stream);
+    }
+    writer->text.length = 0;
+}
+
+void *reportWriterThread(void *arg) {
+    ReportWriter *writer = arg;
+    pthread_mutex_lock(&writer->lock);
+    for (;;) {
+        while (writer->queued == 0 && !writer->closing) {
+            pthread_cond_wait(&writer->ready, &writer->lock);
+        }
+        if (writer->queued == 0) {
+            break;
+        }
+        ReportBatch *batch = &writer->batches[writer->next_write];
+        pthread_mutex_unlock(&writer->lock);
+        writeReportBatch(writer, batch);
+        pthread_mutex_lock(&writer->lock);
+        batch->count = 0;
+        writer->next_write = (writer->next_write + 1) % REPORT_BATCHES;
+        writer->queued--;
+        pthread_cond_broadcast(&writer->drained);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+bool openReportWriter(ReportWriter *writer, FILE *stream, ReportFormat format) {
+    memset(writer, 0, sizeof(*writer));
+    writer->stream = stream;
+    writer->format = format;
+    writer->batches = calloc(REPORT_BATCHES, sizeof(ReportBatch));
+    if (writer->batches == NULL || !reserveReport(&writer->text, REPORT_BUFFER_BYTES)) {
+        printf("Error: unable to allocate the report writer.\n");
+        free(writer->batches);
+        free(writer->text.data);
+        writer->batches = NULL;
+        return false;
+    }
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->ready, NULL);
+    pthread_cond_init(&writer->drained, NULL);
+    writer->threaded = pthread_create(&writer->thread, NULL, reportWriterThread, writer) == 0;
+    return true;
+}
+
+// Hands the batch being filled to the writer thread and moves on to the next one.
+void submitReportBatch(ReportWriter *writer) {
+    ReportBatch *batch = &writer->batches[writer->filling];
+    if (batch->count == 0) {
+        return;
+    }
+    if (!writer->threaded) {
+        writeReportBatch(writer, batch);
+        batch->count = 0;
+        return;
+    }
+    pthread_mutex_lock(&writer->lock);
+    writer->queued++;
+    pthread_cond_signal(&writer->ready);
+    while (writer->queued == REPORT_BATCHES) {
+        pthread_cond_wait(&writer->drained, &writer->lock);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    writer->filling = (writer->filling + 1) % REPORT_BATCHES;
+}
+
+ReportRecord *nextReportRecord(ReportWriter *writer, ReportRecordKind kind) {
+    if (writer->batches == NULL) {
+        return NULL;
+    }
+    if (writer->batches[writer->filling].count == REPORT_BATCH_RECORDS) {
+        submitReportBatch(writer);
+    }
+    ReportBatch *batch = &writer->batches[writer->filling];
+    ReportRecord *record = &batch->records[batch->count++];
+    record->kind = kind;
+    return record;
+}
+
+void queueReportEvent(ReportWriter *writer, ReportRecordKind kind, const SeismicEvent *event) {
+    ReportRecord *record = nextReportRecord(writer, kind);
+    if (record != NULL) {
+        record->event = *event;
+    }
+}
+
+void queueReportStation(ReportWriter *writer, ReportRecordKind kind, const SeismicStation *station) {
+    ReportRecord *record = nextReportRecord(writer, kind);
+    if (record != NULL) {
+        record->station.station_id = station->station_id;
+        record->station.event_count = station->event_count;
+        memcpy(record->station.location, station->location, sizeof(record->station.location));
+    }
+}
+
+void queueReportRisk(ReportWriter *writer, long total_events, long strong_events, const GutenbergRichterFit *fit) {
+    ReportRecord *record = nextReportRecord(writer, REPORT_RISK);
+    if (record != NULL) {
+        record->risk.total_events = total_events;
+        record->risk.strong_events = strong_events;
+        record->risk.fit = *fit;
+    }
+}
+
+// impacts[] is indexed by impact class, as eventImpactClass.
+void queueReportSummary(ReportWriter *writer, long alerts, long events_analyzed, const long *impacts) {
+    ReportRecord *record = nextReportRecord(writer, REPORT_SUMMARY);
+    if (record != NULL) {
+        record->summary.alerts = alerts;
+        record->summary.events_analyzed = events_analyzed;
+        memcpy(record->summary.impacts, impacts, sizeof(record->summary.impacts));
+    }
+}
+
+void queueReportFormatted(ReportWriter *writer, const char *data, size_t length) {
+    ReportRecord *record = nextReportRecord(writer, REPORT_FORMATTED);
+    if (record != NULL) {
+        record->formatted.data = data;
+        record->formatted.length = length;
+    }
+}
+
+bool parseReportFormat(const char *name, ReportFormat *format) {
+    static const char *const names[] = {"text", "jsonl", "binary"};
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *format = (ReportFormat)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns once everything queued so far has been written to the stream.
+void flushReportWriter(ReportWriter *writer) {
+    if (writer->batches == NULL) {
+        return;
+    }
+    submitReportBatch(writer);
+    if (writer->threaded) {
+        pthread_mutex_lock(&writer->lock);
+        while (writer->queued > 0) {
+            pthread_cond_wait(&writer->drained, &writer->lock);
+        }
+        pthread_mutex_unlock(&writer->lock);
+    }
+    fflush(writer->stream);
+}
+
+void closeReportWriter(ReportWriter *writer) {
+    if (writer->batches == NULL) {
+        return;
+    }
+    flushReportWriter(writer);
+    if (writer->threaded) {
+        pthread_mutex_lock(&writer->lock);
+        writer->closing = true;
+        pthread_cond_signal(&writer->ready);
+        pthread_mutex_unlock(&writer->lock);
+        pthread_join(writer->thread, NULL);
+    }
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->ready);
+    pthread_cond_destroy(&writer->drained);
+    free(writer->batches);
+    free(writer->text.data);
+    memset(writer, 0, sizeof(*writer));
+}
+
+uint64_t packStationRange(uint32_t begin, uint32_t end) {
+    return (uint64_t)begin << 32 | end;
+}
+
+void runStationChunk(StationPool *pool, PoolWorker *worker, uint32_t begin, uint32_t end) {
+    for (uint32_t station = begin; station < end; station++) {
+        size_t offset = worker->output.length;
+        pool->task(pool->context, worker, (int)station);
+        if (pool->station_output != NULL) {
+            pool->station_output[station].worker = worker->id;
+            pool->station_output[station].offset = offset;
+            pool->station_output[station].length = worker->output.length - offset;
+        }
+    }
+}
+
+// Works through the worker's own range in small chunks, then steals the back half of
+// the largest remaining range until a full pass finds nothing. Tasks never create new
+// work, so an empty pass means the job is finished for this worker.
+void drainStationRanges(StationPool *pool, PoolWorker *worker) {
+    for (;;) {
+        uint64_t range = atomic_load_explicit(&worker->range, memory_order_acquire);
+        uint32_t begin = (uint32_t)(range >> 32), end = (uint32_t)range;
+        if (begin < end) {
+            uint32_t next = end - begin > POOL_CHUNK_STATIONS ? begin + POOL_CHUNK_STATIONS : end;
+            if (atomic_compare_exchange_weak_explicit(&worker->range, &range, packStationRange(next, end),
+                                                      memory_order_acq_rel, memory_order_acquire)) {
+                runStationChunk(pool, worker, begin, next);
+            }
+            continue;
+        }
+
+        bool stolen = false;
+        for (int attempt = 0; attempt < 2 && !stolen; attempt++) {
+            PoolWorker *victim = NULL;
+            uint32_t largest = 0;
+            for (int i = 1; i < pool->worker_count; i++) {
+                PoolWorker *candidate = &pool->workers[(worker->id + i) % pool->worker_count];
+                uint64_t other = atomic_load_explicit(&candidate->range, memory_order_acquire);
+                uint32_t size = (uint32_t)other - (uint32_t)(other >> 32);
+                if ((uint32_t)(other >> 32) < (uint32_t)other && size > largest) {
+                    largest = size;
+                    victim = candidate;
+                }
+            }
+            if (victim == NULL) {
+                break;
+            }
+            uint64_t other = atomic_load_explicit(&victim->range, memory_order_acquire);
+            uint32_t victimBegin = (uint32_t)(other >> 32), victimEnd = (uint32_t)other;
+            if (victimBegin >= victimEnd) {
+                continue;
+            }
+            uint32_t middle = victimBegin + (victimEnd - victimBegin) / 2;
+            if (atomic_compare_exchange_strong_explicit(&victim->range, &other, packStationRange(victimBegin, middle),
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                atomic_store_explicit(&worker->range, packStationRange(middle, victimEnd), memory_order_release);
+                stolen = true;
+            }
+        }
+        if (!stolen) {
+            uint64_t remaining = 0;
+            for (int i = 0; i < pool->worker_count; i++) {
+                uint64_t other = atomic_load_explicit(&pool->workers[i].range, memory_order_acquire);
+                remaining += (uint32_t)(other >> 32) < (uint32_t)other;
+            }
+            if (remaining == 0) {
+                return;
+            }
+        }
+    }
+}
+
+void *stationPoolThread(void *arg) {
+    PoolWorker *worker = arg;
+    StationPool *pool = worker->pool;
+    unsigned long seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->stopping) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stopping) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        drainStationRanges(pool, worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->active == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// The calling thread acts as worker 0, so a pool of n workers starts n - 1 threads.
+bool createStationPool(StationPool *pool, int worker_count) {
+    memset(pool, 0, sizeof(*pool));
+    if (worker_count < 1) worker_count = 1;
+    if (worker_count > POOL_MAX_WORKERS) worker_count = POOL_MAX_WORKERS;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    for (int i = 0; i < worker_count; i++) {
+        pool->workers[i].id = i;
+        pool->workers[i].pool = pool;
+        atomic_init(&pool->workers[i].range, 0);
+    }
+    pool->worker_count = 1;
+    for (int i = 1; i < worker_count; i++) {
+        if (pthread_create(&pool->threads[i], NULL, stationPoolThread, &pool->workers[i]) != 0) {
+            printf("Error: started only %d of %d pool workers.\n", i, worker_count);
+            break;
+        }
+        pool->worker_count++;
+    }
+    return true;
+}
+
+void destroyStationPool(StationPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 1; i < pool->worker_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (int i = 0; i < pool->worker_count; i++) {
+        free(pool->workers[i].output.data);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+}
+
+// Runs task once per station and resets the per-worker reductions beforehand. When
+// station_output is given, it records where each station's text landed.
+void runStationPool(StationPool *pool, int station_count, StationTask task, void *context, StationOutput *station_output) {
+    for (int i = 0; i < pool->worker_count; i++) {
+        PoolWorker *worker = &pool->workers[i];
+        uint32_t begin = (uint32_t)((int64_t)station_count * i / pool->worker_count);
+        uint32_t end = (uint32_t)((int64_t)station_count * (i + 1) / pool->worker_count);
+        atomic_store_explicit(&worker->range, packStationRange(begin, end), memory_order_relaxed);
+        worker->output.length = 0;
+        worker->events_analyzed = worker->alerts = 0;
+        worker->high_impact = worker->moderate_impact = worker->low_impact = 0;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->context = context;
+    pool->station_output = station_output;
+    pool->active = pool->worker_count - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    drainStationRanges(pool, &pool->workers[0]);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Queues the buffered records in station order, whichever worker formatted them. The
+// writer only references the worker buffers, so it must be flushed before the pool runs
+// again.
+void emitStationOutput(StationPool *pool, const StationOutput *station_output, int station_count, ReportWriter *writer) {
+    for (int s = 0; s < station_count; s++) {
+        const StationOutput *slice = &station_output[s];
+        if (slice->length > 0) {
+            queueReportFormatted(writer, pool->workers[slice->worker].output.data + slice->offset, slice->length);
+        }
+    }
+}
+
+// rand() is neither thread-safe nor reproducible across thread counts, so each station
+// draws from its own generator seeded by its id.
+int nextStationRandom(uint32_t *state) {
+    *state = *state * 1103515245u + 12345u;
+    return (int)((*state >> 16) & 0x7fff);
+}
+
+void simulateStationTask(void *context, PoolWorker *worker, int station) {
+    SeismicNetwork *network = context;
+    SeismicEventTable *table = &network->events;
+    uint32_t state = (uint32_t)network->stations[station].station_id * 2654435761u;
+    int row = station * EVENTS_PER_STATION;
+    (void)worker;
+
+    for (int j = 0; j < EVENTS_PER_STATION; j++, row++) {
+        table->station[row] = station;
+        table->timestamp_ns[row] = civilTimestamp(2025, 3, j + 1, 12, 0, j * 5);
+        table->latitude[row] = (nextStationRandom(&state) % 180) - 90;
+        table->longitude[row] = (nextStationRandom(&state) % 360) - 180;
+        table->depth[row] = nextStationRandom(&state) % 700;
+        table->magnitude[row] = (nextStationRandom(&state) % 10) + 4;
+        table->event_detected[row] = (nextStationRandom(&state) % 2) == 0;
+    }
+}
+
+// Replaces the table contents with EVENTS_PER_STATION rows per station, generated in
+// parallel into pre-sized columns so workers never append concurrently.
+void simulateSeismicActivityParallel(SeismicNetwork *network, StationPool *pool) {
+    SeismicEventTable *table = &network->events;
+    int total = network->station_count * EVENTS_PER_STATION;
+    resetNetwork(network);
+    while (table->capacity < total) {
+        if (!growEventTable(table)) {
+            printf("Error: unable to size the event table for %d events.\n", total);
+            return;
+        }
+    }
+    runStationPool(pool, network->station_count, simulateStationTask, network, NULL);
+    table->count = total;
+    for (int i = 0; i < network->station_count; i++) {
+        network->stations[i].event_count = EVENTS_PER_STATION;
+    }
+    for (int row = 0; row < total; row++) {
+        updateEventMagnitude(network, table->station[row], table->latitude[row], table->longitude[row], table->magnitude[row], 1);
+    }
+    indexStationEvents(network);
+}
+
+void processStationTask(void *context, PoolWorker *worker, int station) {
+    SeismicNetwork *network = context;
+    SeismicEventTable *table = &network->events;
+    for (int i = table->station_offsets[station]; i < table->station_offsets[station + 1]; i++) {
+        int row = table->station_rows[i];
+        if (table->event_detected[row] && table->magnitude[row] >= 6.0) {
+            ReportRecord record = {.kind = REPORT_ALERT};
+            loadSeismicEvent(table, row, &record.event);
+            formatReportRecord(&worker->output, reportWriter.format, &record);
+            worker->alerts++;
+        }
+    }
+}
+
+// Returns the number of alerts issued.
+long processSeismicDataParallel(SeismicNetwork *network, StationPool *pool, StationOutput *station_output) {
+    long alerts = 0;
+    if (indexStationEvents(network)) {
+        runStationPool(pool, network->station_count, processStationTask, network, station_output);
+        for (int i = 0; i < pool->worker_count; i++) {
+            alerts += pool->workers[i].alerts;
+        }
+    }
+    return alerts;
+}
+
+void analyzeStationTask(void *context, PoolWorker *worker, int station) {
+    SeismicNetwork *network = context;
+    SeismicEventTable *table = &network->events;
+    for (int i = table->station_offsets[station]; i < table->station_offsets[station + 1]; i++) {
+        ReportRecord record = {.kind = REPORT_IMPACT};
+        loadSeismicEvent(table, table->station_rows[i], &record.event);
+        formatReportRecord(&worker->output, reportWriter.format, &record);
+        int impact = eventImpactClass(&record.event);
+        worker->high_impact += impact == 2;
+        worker->moderate_impact += impact == 1;
+        worker->low_impact += impact == 0;
+        worker->events_analyzed++;
+    }
+}
+
+// Returns the number of events analyzed and fills impacts[] with the count per impact
+// class, as eventImpactClass.
+long analyzeSeismicDataParallel(SeismicNetwork *network, StationPool *pool, StationOutput *station_output, long *impacts) {
+    long analyzed = 0;
+    impacts[0] = impacts[1] = impacts[2] = 0;
+    if (indexStationEvents(network)) {
+        runStationPool(pool, network->station_count, analyzeStationTask, network, station_output);
+        for (int i = 0; i < pool->worker_count; i++) {
+            const PoolWorker *worker = &pool->workers[i];
+            analyzed += worker->events_analyzed;
+            impacts[0] += worker->low_impact;
+            impacts[1] += worker->moderate_impact;
+            impacts[2] += worker->high_impact;
+        }
+    }
+    return analyzed;
+}
+
+int availableCores(void) {
+#ifdef _WIN32
+    return 1;
+#else
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+#endif
+}
+
+// Same sequence as the serial main, with the per-station phases on the pool. The output
+// does not depend on the worker count.
+void runParallelNetwork(int station_count, int worker_count, ReportFormat format) {
+    SeismicNetwork network;
+    StationPool pool;
+    memset(&network, 0, sizeof(network));
+    for (int i = 0; i < station_count; i++) {
+        char location[50];
+        sprintf(location, "Station %d Location", i + 1);
+        addSeismicStation(&network, i + 1, location);
+    }
+    StationOutput *station_output = calloc(network.station_count + 1, sizeof(StationOutput));
+    if (station_output == NULL || !openReportWriter(&reportWriter, stdout, format)) {
+        free(station_output);
+        freeSeismicNetwork(&network);
+        return;
+    }
+    if (!createStationPool(&pool, worker_count)) {
+        closeReportWriter(&reportWriter);
+        free(station_output);
+        freeSeismicNetwork(&network);
+        return;
+    }
+
+    long impacts[3];
+    simulateSeismicActivityParallel(&network, &pool);
+    long alerts = processSeismicDataParallel(&network, &pool, station_output);
+    emitStationOutput(&pool, station_output, network.station_count, &reportWriter);
+    printSeismicNetworkStatus(&network);
+    flushReportWriter(&reportWriter);
+    long analyzed = analyzeSeismicDataParallel(&network, &pool, station_output, impacts);
+    emitStationOutput(&pool, station_output, network.station_count, &reportWriter);
+    queueReportSummary(&reportWriter, alerts, analyzed, impacts);
+    analyzeGlobalSeismicRisk(&network);
+
+    closeReportWriter(&reportWriter);
+    destroyStationPool(&pool);
+    free(station_output);
+    freeSeismicNetwork(&network);
+}
+
+double monotonicSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Times the parallel phases for 1, 2, 4, ... workers up to max_workers (normally the
+// core count). Station text is formatted into the worker buffers but not written out.
+void measureParallelScaling(int station_count, int max_workers) {
+    SeismicNetwork network;
+    int cores = availableCores();
+    double baseline = 0;
+    memset(&network, 0, sizeof(network));
+    for (int i = 0; i < station_count; i++) {
+        char location[50];
+        sprintf(location, "Station %d Location", i + 1);
+        addSeismicStation(&network, i + 1, location);
+    }
+    StationOutput *station_output = calloc(network.station_count + 1, sizeof(StationOutput));
+    if (station_output == NULL) {
+        freeSeismicNetwork(&network);
+        return;
+    }
+
+    printf("Parallel scaling over %d stations, %d cores:\n", station_count, cores);
+    for (int workers = 1;; workers = workers * 2 > max_workers ? max_workers : workers * 2) {
+        StationPool pool;
+        long impacts[3];
+        createStationPool(&pool, workers);
+        double start = monotonicSeconds();
+        simulateSeismicActivityParallel(&network, &pool);
+        processSeismicDataParallel(&network, &pool, station_output);
+        analyzeSeismicDataParallel(&network, &pool, station_output, impacts);
+        double elapsed = monotonicSeconds() - start;
+        if (workers == 1) {
+            baseline = elapsed;
+        }
+        printf("  %2d workers: %8.2f ms, speedup %.2fx\n", pool.worker_count, elapsed * 1e3, baseline / elapsed);
+        destroyStationPool(&pool);
+        if (workers >= max_workers) {
+            break;
+        }
+    }
+
+    free(station_output);
+    freeSeismicNetwork(&network);
+}
+
+// Even coverage of the globe for simulated networks: a Fibonacci lattice.
+void placeStationsOnSphere(SeismicNetwork *network) {
+    double golden_angle = M_PI * (3.0 - sqrt(5.0));
+    for (int i = 0; i < network->station_count; i++) {
+        double z = 1.0 - (2.0 * i + 1.0) / network->station_count;
+        double longitude = fmod(i * golden_angle, 2 * M_PI);
+        network->stations[i].latitude = (float)(asin(z) * 180.0 / M_PI);
+        network->stations[i].longitude = (float)(longitude * 180.0 / M_PI - 180.0);
+    }
+}
+
+void stationUnitVector(const SeismicStation *station, double *vector) {
+    double latitude = station->latitude * M_PI / 180.0;
+    double longitude = station->longitude * M_PI / 180.0;
+    vector[0] = cos(latitude) * cos(longitude);
+    vector[1] = cos(latitude) * sin(longitude);
+    vector[2] = sin(latitude);
+}
+
+double greatCircleKm(double lat1, double lon1, double lat2, double lon2) {
+    double dlat = (lat2 - lat1) * M_PI / 180.0;
+    double dlon = (lon2 - lon1) * M_PI / 180.0;
+    double a = sin(dlat / 2) * sin(dlat / 2) +
+               cos(lat1 * M_PI / 180.0) * cos(lat2 * M_PI / 180.0) * sin(dlon / 2) * sin(dlon / 2);
+    return 2 * EARTH_RADIUS_KM * atan2(sqrt(a), sqrt(1 - a));
+}
+
+// Gathers the detected rows of the event table as time-ordered detections by walking the
+// network-wide time index. Returns the count, or -1 if the index or the array could not
+// be allocated.
+int collectDetections(SeismicNetwork *network, Detection **detections) {
+    SeismicEventTable *table = &network->events;
+    int count = 0;
+    if (!indexStationEvents(network)) {
+        return -1;
+    }
+    *detections = malloc((table->count + 1) * sizeof(Detection));
+    if (*detections == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < table->count; i++) {
+        int row = table->time_rows[i];
+        if (table->event_detected[row]) {
+            Detection *detection = &(*detections)[count++];
+            detection->station = table->station[row];
+            detection->row = row;
+            detection->time = (double)table->timestamp_ns[row] / NS_PER_SECOND;
+            detection->magnitude = table->magnitude[row];
+        }
+    }
+    return count;
+}
+
+// Cells are cubes of side one association chord in unit-vector space, which avoids the
+// pole and antimeridian special cases of latitude/longitude cells, crossed with time
+// buckets one association window long. Spatial indices need 7 bits each, the bucket 43.
+uint64_t associationCell(int cx, int cy, int cz, int64_t bucket) {
+    return ((uint64_t)(cx & 0x7f) << 57) | ((uint64_t)(cy & 0x7f) << 50) | ((uint64_t)(cz & 0x7f) << 43) |
+           ((uint64_t)bucket & 0x7ffffffffffULL);
+}
+
+uint32_t hashAssociationCell(uint64_t cell, uint32_t mask) {
+    cell ^= cell >> 33;
+    cell *= 0xff51afd7ed558ccdULL;
+    cell ^= cell >> 33;
+    return (uint32_t)cell & mask;
+}
+
+// Two detections can belong to one event if their stations are within
+// ASSOCIATION_RADIUS_KM and their arrival-time difference is no larger than the
+// inter-station distance at the slowest P velocity of the model, its surface layer, plus
+// ASSOCIATION_TOLERANCE_S for pick error.
+bool detectionsConsistent(const double *vectors, const Detection *a, const Detection *b) {
+    const double *station = &vectors[3 * a->station];
+    const double *other = &vectors[3 * b->station];
+    double dot = station[0] * other[0] + station[1] * other[1] + station[2] * other[2];
+    double distance = EARTH_RADIUS_KM * acos(dot > 1 ? 1 : (dot < -1 ? -1 : dot));
+    return distance <= ASSOCIATION_RADIUS_KM &&
+           fabs(a->time - b->time) <= distance / velocityModel[0].velocity + ASSOCIATION_TOLERANCE_S;
+}
+
+double unitChord(const double *a, const double *b) {
+    double squared = 2 - 2 * (a[0] * b[0] + a[1] * b[1] + a[2] * b[2]);
+    return sqrt(squared > 0 ? squared : 0);
+}
+
+// Scores a trial source for a seed. The origin time is the one that puts the seed's
+// arrival on the model, and a neighbour matches if its arrival is within tolerance of the
+// predicted one. Matches are weighted down quadratically towards the tolerance, so on a
+// coarse level, where the tolerance admits nearly everything, close fits still decide.
+void scoreAssociationHypothesis(const AssociationScan *scan, double tolerance, AssociationHypothesis *hypothesis) {
+    const TravelTimeTable *table = scan->table;
+    const double *restrict x = scan->x;
+    const double *restrict y = scan->y;
+    const double *restrict z = scan->z;
+    const double *restrict arrival = scan->arrival;
+    const double *position = hypothesis->position;
+    double row = hypothesis->depth / table->depth_step;
+    row = row < table->depth_count - 1.000001 ? (row > 0 ? row : 0) : table->depth_count - 1.000001;
+    int r = (int)row;
+    double depth_weight = row - r;
+    const float *restrict upper = table->times + (size_t)r * table->chord_count;
+    const float *restrict lower = upper + table->chord_count;
+    double scale = 1.0 / table->chord_step, limit = table->chord_count - 1.000001;
+
+    hypothesis->origin = scan->seed_arrival -
+                         lookupTravelTime(table, unitChord(position, scan->seed), hypothesis->depth);
+    int matches = 0;
+    double score = 0;
+    for (int i = 0; i < scan->pick_count; i++) {
+        double squared = 2 - 2 * (position[0] * x[i] + position[1] * y[i] + position[2] * z[i]);
+        double column = sqrt(squared > 0 ? squared : 0) * scale;
+        column = column < limit ? column : limit;
+        int c = (int)column;
+        double w = column - c;
+        double near = upper[c] + w * (upper[c + 1] - upper[c]);
+        double far = lower[c] + w * (lower[c + 1] - lower[c]);
+        double residual = (arrival[i] - hypothesis->origin - (near + depth_weight * (far - near))) / tolerance;
+        double fit = 1 - residual * residual;
+        matches += fit >= 0;
+        score += fit > 0 ? fit : 0;
+    }
+    hypothesis->matches = matches;
+    hypothesis->score = score;
+}
+
+// Match tolerance for a scan level: pick error plus the worst travel-time error from
+// evaluating the source at the nearest node rather than where it is. The seed's arrival
+// fixes the origin time, so its node error counts too.
+double hypothesisTolerance(double step_km, double depth_step_km) {
+    return ASSOCIATION_MATCH_S + (M_SQRT2 * step_km + depth_step_km) / velocityModel[0].velocity;
+}
+
+// Grid search for the source of a seed detection. Nodes form a square in the plane
+// tangent to the sphere at the seed's station, out to radius_km, by a column of depths.
+// Each later level recentres a smaller square of ASSOCIATION_REFINE_NODES on the best
+// node of the previous one, with both steps divided by ASSOCIATION_SCAN_REFINE, so it
+// still covers the previous level's cell. The best node has the highest score.
+AssociationHypothesis scanSeedHypotheses(const AssociationScan *scan, double radius_km) {
+    const double *station = scan->seed;
+    double pole[3] = {fabs(station[2]) < 0.9 ? 0 : 1, 0, fabs(station[2]) < 0.9 ? 1 : 0};
+    double east[3] = {pole[1] * station[2] - pole[2] * station[1], pole[2] * station[0] - pole[0] * station[2],
+                      pole[0] * station[1] - pole[1] * station[0]};
+    double norm = sqrt(east[0] * east[0] + east[1] * east[1] + east[2] * east[2]);
+    east[0] /= norm;
+    east[1] /= norm;
+    east[2] /= norm;
+    double north[3] = {station[1] * east[2] - station[2] * east[1], station[2] * east[0] - station[0] * east[2],
+                       station[0] * east[1] - station[1] * east[0]};
+
+    double centre_x = 0, centre_y = 0, centre_depth = LOCATE_MAX_DEPTH_KM / 2;
+    double step = radius_km / ASSOCIATION_SCAN_NODES;
+    double depth_step = LOCATE_MAX_DEPTH_KM / (2 * ASSOCIATION_SCAN_DEPTHS);
+    AssociationHypothesis best = {{0, 0, 0}, 0, 0, 0, -1};
+    for (int level = 0; level < ASSOCIATION_SCAN_LEVELS; level++) {
+        double tolerance = hypothesisTolerance(step, depth_step);
+        AssociationHypothesis level_best = {{0, 0, 0}, 0, 0, 0, -1};
+        double best_x = centre_x, best_y = centre_y;
+        int nodes = level == 0 ? ASSOCIATION_SCAN_NODES : ASSOCIATION_REFINE_NODES;
+        int depths = level == 0 ? ASSOCIATION_SCAN_DEPTHS : ASSOCIATION_REFINE_NODES;
+        for (int k = -depths; k <= depths; k++) {
+            double depth = centre_depth + k * depth_step;
+            if (depth < 0 || depth > LOCATE_MAX_DEPTH_KM) {
+                continue;
+            }
+            for (int i = -nodes; i <= nodes; i++) {
+                for (int j = -nodes; j <= nodes; j++) {
+                    double x = (centre_x + i * step) / EARTH_RADIUS_KM, y = (centre_y + j * step) / EARTH_RADIUS_KM;
+                    AssociationHypothesis trial = {{station[0] + x * east[0] + y * north[0],
+                                                    station[1] + x * east[1] + y * north[1],
+                                                    station[2] + x * east[2] + y * north[2]},
+                                                   depth, 0, 0, 0};
+                    double length = sqrt(trial.position[0] * trial.position[0] + trial.position[1] * trial.position[1] +
+                                         trial.position[2] * trial.position[2]);
+                    trial.position[0] /= length;
+                    trial.position[1] /= length;
+                    trial.position[2] /= length;
+                    scoreAssociationHypothesis(scan, tolerance, &trial);
+                    if (trial.score > level_best.score) {
+                        level_best = trial;
+                        best_x = centre_x + i * step;
+                        best_y = centre_y + j * step;
+                    }
+                }
+            }
+        }
+        best = level_best;
+        centre_x = best_x;
+        centre_y = best_y;
+        centre_depth = best.depth;
+        step /= ASSOCIATION_SCAN_REFINE;
+        depth_step /= ASSOCIATION_SCAN_REFINE;
+    }
+    return best;
+}
+
+void queueSeed(SeedQueue *queue, int seed, int key) {
+    queue->key[seed] = key;
+    queue->prev[seed] = -1;
+    queue->next[seed] = queue->head[key];
+    if (queue->head[key] >= 0) {
+        queue->prev[queue->head[key]] = seed;
+    }
+    queue->head[key] = seed;
+}
+
+void unqueueSeed(SeedQueue *queue, int seed) {
+    if (queue->prev[seed] >= 0) {
+        queue->next[queue->prev[seed]] = queue->next[seed];
+    } else {
+        queue->head[queue->key[seed]] = queue->next[seed];
+    }
+    if (queue->next[seed] >= 0) {
+        queue->prev[queue->next[seed]] = queue->prev[seed];
+    }
+}
+
+// Collects the detections that could share an event with a seed: untaken, from another
+// station, and consistent with it (see detectionsConsistent). They are found through the
+// spatio-temporal hash of all detections: unit-vector cubes one association chord wide,
+// by time buckets one association window long, so a seed probes a fixed 27 x 3 cells
+// rather than every detection.
+int gatherAssociationNeighbours(const double *vectors, const Detection *detections, const int *cells,
+                                const int *heads, const int *chain, uint32_t mask, const int *detection_event,
+                                int seed, int *neighbours) {
+    const int *cell = &cells[4 * seed];
+    int neighbour_count = 0;
+    for (int probe = 0; probe < 81; probe++) {
+        uint64_t key = associationCell(cell[0] + probe % 3 - 1, cell[1] + probe / 3 % 3 - 1,
+                                       cell[2] + probe / 9 % 3 - 1, cell[3] + probe / 27 - 1);
+        for (int d = heads[hashAssociationCell(key, mask)]; d >= 0; d = chain[d]) {
+            const int *other = &cells[4 * d];
+            if (d != seed && detection_event[d] < 0 && associationCell(other[0], other[1], other[2], other[3]) == key &&
+                detections[d].station != detections[seed].station &&
+                detectionsConsistent(vectors, &detections[seed], &detections[d])) {
+                neighbours[neighbour_count++] = d;
+            }
+        }
+    }
+    return neighbour_count;
+}
+
+// Groups time-ordered detections into network events. Every detection is a seed for a
+// possible event whose source scanSeedHypotheses searches for near the seed's station.
+// Seeds are taken best first, by how many neighbours their source explains, from a
+// bucket queue keyed on that count. A seed starts keyed on its neighbour count, an upper
+// bound, and is scanned when it reaches the top. When it reaches the top again with the
+// same neighbours still untaken its count is exact, and the seed and its matching
+// neighbours, at most one per station, become an event if they reach
+// ASSOCIATION_MIN_STATIONS; otherwise it is rescanned and requeued. Taking the
+// best-supported event first means a false trigger or a stray pick, which explains few
+// neighbours, cannot capture the picks of a real event, and two earthquakes close in
+// space and time are told apart by their sources rather than by pairwise timing alone.
+// Events are numbered by their first arrival, which also gives their provisional origin
+// time and epicenter.
+bool associateDetections(SeismicNetwork *network, const TravelTimeTable *table, Detection *detections, int count,
+                         AssociationResult *result) {
+    double cell_size = 2 * sin(ASSOCIATION_RADIUS_KM / EARTH_RADIUS_KM / 2);
+    double window = ASSOCIATION_RADIUS_KM / velocityModel[0].velocity + ASSOCIATION_TOLERANCE_S;
+    double spacing = EARTH_RADIUS_KM * sqrt(4 * M_PI / (network->station_count > 0 ? network->station_count : 1));
+    double radius = fmin(ASSOCIATION_SEED_SPACINGS * spacing, ASSOCIATION_RADIUS_KM / 2);
+    double scan_step = radius / ASSOCIATION_SCAN_NODES;
+    double scan_depth_step = LOCATE_MAX_DEPTH_KM / (2 * ASSOCIATION_SCAN_DEPTHS);
+    for (int level = 1; level < ASSOCIATION_SCAN_LEVELS; level++) {
+        scan_step /= ASSOCIATION_SCAN_REFINE;
+        scan_depth_step /= ASSOCIATION_SCAN_REFINE;
+    }
+    double tolerance = hypothesisTolerance(scan_step, scan_depth_step);
+    double near_dot = cos(radius / EARTH_RADIUS_KM);
+    uint32_t table_size = 1024;
+    while (table_size < 2u * (uint32_t)count) {
+        table_size *= 2;
+    }
+
+    memset(result, 0, sizeof(*result));
+    int *heads = malloc(table_size * sizeof(int));
+    int *chain = malloc((count + 1) * sizeof(int));
+    int *cells = malloc((4 * count + 1) * sizeof(int));
+    int *neighbours = malloc((count + 1) * sizeof(int));
+    AssociationScan scan = {table, 0, malloc((count + 1) * sizeof(double)), malloc((count + 1) * sizeof(double)),
+                            malloc((count + 1) * sizeof(double)), malloc((count + 1) * sizeof(double)), {0, 0, 0}, 0};
+    SeedQueue queue = {malloc((count + 1) * sizeof(int)), malloc((count + 1) * sizeof(int)),
+                       malloc((count + 1) * sizeof(int)), malloc((count + 1) * sizeof(int))};
+    int *scanned = malloc((count + 1) * sizeof(int));
+    AssociationHypothesis *sources = malloc((count + 1) * sizeof(AssociationHypothesis));
+    int *station_pick = malloc((network->station_count + 1) * sizeof(int));
+    double *vectors = malloc((3 * network->station_count + 1) * sizeof(double));
+    result->events = malloc((count / ASSOCIATION_MIN_STATIONS + 1) * sizeof(NetworkEvent));
+    result->detection_event = malloc((count + 1) * sizeof(int));
+    bool ok = heads != NULL && chain != NULL && cells != NULL && neighbours != NULL && scan.x != NULL &&
+              scan.y != NULL && scan.z != NULL && scan.arrival != NULL && queue.head != NULL && queue.next != NULL &&
+              queue.prev != NULL && queue.key != NULL && scanned != NULL && sources != NULL && station_pick != NULL &&
+              vectors != NULL && result->events != NULL && result->detection_event != NULL;
+
+    for (int i = 0; ok && i < network->station_count; i++) {
+        stationUnitVector(&network->stations[i], &vectors[3 * i]);
+        station_pick[i] = -1;
+    }
+    for (uint32_t i = 0; ok && i < table_size; i++) {
+        heads[i] = -1;
+    }
+    for (int d = 0; ok && d < count; d++) {
+        int *cell = &cells[4 * d];
+        const double *vector = &vectors[3 * detections[d].station];
+        cell[0] = (int)floor((vector[0] + 1) / cell_size);
+        cell[1] = (int)floor((vector[1] + 1) / cell_size);
+        cell[2] = (int)floor((vector[2] + 1) / cell_size);
+        cell[3] = (int)floor((detections[d].time - detections[0].time) / window);
+        uint32_t slot = hashAssociationCell(associationCell(cell[0], cell[1], cell[2], cell[3]), table_size - 1);
+        chain[d] = heads[slot];
+        heads[slot] = d;
+        result->detection_event[d] = -1;
+        queue.head[d] = -1;
+        scanned[d] = -1;
+    }
+    if (ok) {
+        queue.head[count] = -1;
+    }
+    // Walked backwards so each bucket lists its seeds in time order.
+    for (int d = count - 1; ok && d >= 0; d--) {
+        int key = gatherAssociationNeighbours(vectors, detections, cells, heads, chain, table_size - 1,
+                                              result->detection_event, d, neighbours);
+        queueSeed(&queue, d, key);
+    }
+
+    int accepted = 0, associated = 0;
+    for (int top = count; ok && top + 1 >= ASSOCIATION_MIN_STATIONS;) {
+        int seed = queue.head[top];
+        if (seed < 0) {
+            top--;
+            continue;
+        }
+        unqueueSeed(&queue, seed);
+        queue.key[seed] = -1;
+        if (result->detection_event[seed] >= 0) {
+            continue;
+        }
+        int neighbour_count = gatherAssociationNeighbours(vectors, detections, cells, heads, chain, table_size - 1,
+                                                          result->detection_event, seed, neighbours);
+        if (neighbour_count + 1 < ASSOCIATION_MIN_STATIONS) {
+            continue;
+        }
+        if (neighbour_count != scanned[seed]) {
+            const AssociationHypothesis *source = &sources[seed];
+            const double *seed_vector = &vectors[3 * detections[seed].station];
+            int near = 0;
+            scan.pick_count = neighbour_count;
+            for (int i = 0; i < neighbour_count; i++) {
+                const double *vector = &vectors[3 * detections[neighbours[i]].station];
+                scan.x[i] = vector[0];
+                scan.y[i] = vector[1];
+                scan.z[i] = vector[2];
+                scan.arrival[i] = detections[neighbours[i]].time;
+                near += vector[0] * seed_vector[0] + vector[1] * seed_vector[1] + vector[2] * seed_vector[2] >=
+                        near_dot;
+            }
+            // The source is searched for within radius of the seed's station, so the
+            // stations around it must have seen the event too; an isolated false trigger
+            // is dropped here without a scan.
+            if (near + 1 < ASSOCIATION_MIN_STATIONS) {
+                continue;
+            }
+            memcpy(scan.seed, seed_vector, sizeof(scan.seed));
+            scan.seed_arrival = detections[seed].time;
+            sources[seed] = scanSeedHypotheses(&scan, radius);
+            scanned[seed] = neighbour_count;
+            int key = source->matches < top ? source->matches : top;
+            // A matching neighbour would find much the same event from its own scan, so it
+            // waits behind this seed rather than being scanned first.
+            for (int i = 0; i < neighbour_count; i++) {
+                int other = neighbours[i];
+                const Detection *detection = &detections[other];
+                double residual = fabs(detection->time - source->origin -
+                                       lookupTravelTime(table, unitChord(source->position,
+                                                                         &vectors[3 * detection->station]),
+                                                        source->depth));
+                if (residual <= tolerance && queue.key[other] > key) {
+                    unqueueSeed(&queue, other);
+                    queueSeed(&queue, other, key);
+                }
+            }
+            queueSeed(&queue, seed, key);
+            continue;
+        }
+
+        // Keep the best-fitting pick per station, compacting the matches to the front of
+        // neighbours[].
+        const AssociationHypothesis *source = &sources[seed];
+        int matched = 0;
+        for (int i = 0; i < neighbour_count; i++) {
+            const Detection *detection = &detections[neighbours[i]];
+            double residual = fabs(detection->time - source->origin -
+                                   lookupTravelTime(table, unitChord(source->position, &vectors[3 * detection->station]),
+                                                    source->depth));
+            if (residual > tolerance) {
+                continue;
+            }
+            int *pick = &station_pick[detection->station];
+            if (*pick < 0) {
+                neighbours[matched++] = neighbours[i];
+                *pick = neighbours[i];
+                continue;
+            }
+            const Detection *kept = &detections[*pick];
+            double kept_residual = fabs(kept->time - source->origin -
+                                        lookupTravelTime(table, unitChord(source->position, &vectors[3 * kept->station]),
+                                                         source->depth));
+            if (residual < kept_residual) {
+                for (int m = 0; m < matched; m++) {
+                    neighbours[m] = neighbours[m] == *pick ? neighbours[i] : neighbours[m];
+                }
+                *pick = neighbours[i];
+            }
+        }
+        for (int m = 0; m < matched; m++) {
+            station_pick[detections[neighbours[m]].station] = -1;
+        }
+        if (matched + 1 < ASSOCIATION_MIN_STATIONS) {
+            continue;
+        }
+
+        NetworkEvent *event = &result->events[accepted];
+        event->depth = 0;
+        event->magnitude = detections[seed].magnitude;
+        event->rms = 0;
+        event->located = false;
+        event->station_count = matched + 1;
+        result->detection_event[seed] = accepted;
+        for (int m = 0; m < matched; m++) {
+            event->magnitude += detections[neighbours[m]].magnitude;
+            result->detection_event[neighbours[m]] = accepted;
+        }
+        event->magnitude /= event->station_count;
+        associated += event->station_count;
+        accepted++;
+    }
+
+    // Renumber the events by first arrival; scanned[] is free to map old numbers to new.
+    NetworkEvent *ordered = ok ? malloc((accepted + 1) * sizeof(NetworkEvent)) : NULL;
+    ok = ok && ordered != NULL;
+    for (int e = 0; ok && e < accepted; e++) {
+        scanned[e] = -1;
+    }
+    for (int d = 0, next = 0; ok && d < count; d++) {
+        int e = result->detection_event[d];
+        if (e < 0) {
+            continue;
+        }
+        if (scanned[e] < 0) {
+            const SeismicStation *station = &network->stations[detections[d].station];
+            ordered[next] = result->events[e];
+            ordered[next].origin_time = detections[d].time;
+            ordered[next].latitude = station->latitude;
+            ordered[next].longitude = station->longitude;
+            scanned[e] = next++;
+        }
+        result->detection_event[d] = scanned[e];
+    }
+    if (ok) {
+        free(result->events);
+        result->events = ordered;
+    } else {
+        free(ordered);
+    }
+
+    // Lay the events' stations out contiguously, each list in arrival order.
+    if (ok) {
+        result->stations = malloc((associated + 1) * sizeof(int));
+        result->arrival_times = malloc((associated + 1) * sizeof(double));
+        ok = result->stations != NULL && result->arrival_times != NULL;
+    }
+    for (int e = 0, first = 0; ok && e < accepted; e++) {
+        result->events[e].first_station = first;
+        first += result->events[e].station_count;
+        result->events[e].station_count = 0;
+    }
+    for (int d = 0; ok && d < count; d++) {
+        int e = result->detection_event[d];
+        if (e >= 0) {
+            NetworkEvent *event = &result->events[e];
+            result->stations[event->first_station + event->station_count] = detections[d].station;
+            result->arrival_times[event->first_station + event->station_count++] = detections[d].time;
+        }
+    }
+    if (ok) {
+        result->event_count = accepted;
+        result->detection_count = count;
+        result->unassociated = count - associated;
+    } else {
+        freeAssociationResult(result);
+    }
+
+    free(heads);
+    free(chain);
+    free(cells);
+    free(neighbours);
+    free(scan.x);
+    free(scan.y);
+    free(scan.z);
+    free(scan.arrival);
+    free(queue.head);
+    free(queue.next);
+    free(queue.prev);
+    free(queue.key);
+    free(scanned);
+    free(sources);
+    free(station_pick);
+    free(vectors);
+    return ok;
+}
+
+void freeAssociationResult(AssociationResult *result) {
+    free(result->events);
+    free(result->stations);
+    free(result->arrival_times);
+    free(result->detection_event);
+    memset(result, 0, sizeof(*result));
+}
+
+void printAssociatedEvents(SeismicNetwork *network, const AssociationResult *result, int limit) {
+    printf("Associated %d detections into %d network events (%d unassociated).\n",
+           result->detection_count - result->unassociated, result->event_count, result->unassociated);
+    for (int e = 0; e < result->event_count && e < limit; e++) {
+        const NetworkEvent *event = &result->events[e];
+        char date[11], time[9];
+        formatEventTimestamp((int64_t)floor(event->origin_time) * NS_PER_SECOND, date, time);
+        if (event->located) {
+            printf("Network Event %d: origin %s %s at Lat: %.2f, Long: %.2f, Depth: %.1f km (RMS %.2f s), Magnitude: %.2f, %d stations:",
+                   e + 1, date, time, event->latitude, event->longitude, event->depth, event->rms, event->magnitude,
+                   event->station_count);
+        } else {
+            printf("Network Event %d: first arrival %s %s near Lat: %.2f, Long: %.2f, Magnitude: %.2f, %d stations:",
+                   e + 1, date, time, event->latitude, event->longitude, event->magnitude, event->station_count);
+        }
+        for (int s = 0; s < event->station_count && s < 8; s++) {
+            printf(" %d", network->stations[result->stations[event->first_station + s]].station_id);
+        }
+        printf(event->station_count > 8 ? " ...\n" : "\n");
+    }
+}
+
+// Simulated earthquakes seen by every station within ASSOCIATION_DEMO_RANGE_KM, with a
+// few missed picks and a sprinkling of false triggers, recorded through the normal
+// per-station path, associated, and located. Arrival times come from the layered model
+// plus pick noise, not from the locator's table. Each network event is attributed to the
+// earthquake that produced most of its picks, which gives the split, missed and spurious
+// event counts; located events are scored against that earthquake's hypocenter, both
+// overall and over events with no more than a tenth of their picks from elsewhere.
+void runAssociationDemo(int station_count, int earthquake_count) {
+    SeismicNetwork network;
+    Detection *detections;
+    AssociationResult result;
+    TravelTimeTable table;
+    int64_t start_epoch = daysFromCivil(2025, 3, 1) * 86400;
+    double *truth = malloc((4 * earthquake_count + 1) * sizeof(double));
+    int *quake_rows_end = malloc((earthquake_count + 1) * sizeof(int));
+    if (truth == NULL || quake_rows_end == NULL || !buildTravelTimeTable(&table)) {
+        free(truth);
+        free(quake_rows_end);
+        return;
+    }
+    memset(&network, 0, sizeof(network));
+    for (int i = 0; i < station_count; i++) {
+        char location[50];
+        sprintf(location, "Station %d Location", i + 1);
+        addSeismicStation(&network, i + 1, location);
+    }
+    placeStationsOnSphere(&network);
+    srand(2025);
+
+    for (int q = 0; q < earthquake_count; q++) {
+        double latitude = asin(2.0 * rand() / RAND_MAX - 1) * 180.0 / M_PI;
+        double longitude = 360.0 * rand() / RAND_MAX - 180.0;
+        double origin = start_epoch + (double)rand() / RAND_MAX * 3600.0;
+        float magnitude = 4.0f + 4.0f * rand() / RAND_MAX;
+        double depth = rand() % 4 == 0 ? rand() % 600 : rand() % 60;
+        truth[4 * q] = latitude;
+        truth[4 * q + 1] = longitude;
+        truth[4 * q + 2] = depth;
+        truth[4 * q + 3] = origin;
+        for (int s = 0; s < network.station_count; s++) {
+            SeismicStation *station = &network.stations[s];
+            double distance = greatCircleKm(latitude, longitude, station->latitude, station->longitude);
+            if (distance > ASSOCIATION_DEMO_RANGE_KM || rand() % 10 == 0) {
+                continue;
+            }
+            // Arrivals come from the layered model directly, not from the locator's table,
+            // with Gaussian pick error (Box-Muller).
+            double u1 = (rand() + 1.0) / (RAND_MAX + 2.0), u2 = (double)rand() / RAND_MAX;
+            double pick_error = ASSOCIATION_DEMO_PICK_NOISE_S * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+            SeismicEvent event;
+            event.latitude = (float)latitude + (rand() % 200 - 100) / 100.0f;
+            event.longitude = (float)longitude + (rand() % 200 - 100) / 100.0f;
+            event.depth = (float)depth;
+            event.magnitude = magnitude + (rand() % 60 - 30) / 100.0f;
+            event.event_detected = true;
+            double arrival = origin + layeredTravelTime(distance, depth) + pick_error;
+            event.timestamp_ns = llround(arrival * NS_PER_SECOND);
+            recordSeismicEvent(&network, s, &event);
+        }
+        quake_rows_end[q] = network.events.count;
+    }
+    for (int s = 0; s < network.station_count; s += 20) {
+        SeismicEvent event;
+        simulateEventBasedOnMagnitude(&event);
+        event.event_detected = true;
+        event.timestamp_ns = (start_epoch + rand() % 3600) * NS_PER_SECOND;
+        recordSeismicEvent(&network, s, &event);
+    }
+
+    int count = collectDetections(&network, &detections);
+    if (count < 0) {
+        free(truth);
+        free(quake_rows_end);
+        freeTravelTimeTable(&table);
+        freeSeismicNetwork(&network);
+        return;
+    }
+    double started = monotonicSeconds();
+    if (associateDetections(&network, &table, detections, count, &result)) {
+        double elapsed = monotonicSeconds() - started;
+        StationPool pool;
+        double slowest = 0, total = 0;
+        double *errors = malloc((4 * result.event_count + 1) * sizeof(double));
+        int *event_source = malloc((2 * result.event_count + 1) * sizeof(int));
+        int *quake_picks = calloc(2 * earthquake_count + 1, sizeof(int));
+        int *detection_quake = malloc((count + 1) * sizeof(int));
+        int matched = 0, clean = 0, split = 0, extra = 0, missed = 0, detectable = 0, spurious = 0;
+        bool scored = errors != NULL && event_source != NULL && quake_picks != NULL && detection_quake != NULL;
+
+        // Majority vote per event over the source of its picks; -1 is a false trigger. The
+        // second half of event_source then counts the picks from the winning source.
+        for (int e = 0; scored && e < result.event_count; e++) {
+            event_source[e] = -1;
+            event_source[result.event_count + e] = 0;
+        }
+        for (int d = 0; scored && d < count; d++) {
+            int low = 0, high = earthquake_count;
+            while (low < high) {
+                int mid = (low + high) / 2;
+                if (detections[d].row >= quake_rows_end[mid]) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            int q = low < earthquake_count ? low : -1;
+            if (q >= 0) {
+                quake_picks[q]++;
+            }
+            detection_quake[d] = q;
+            int e = result.detection_event[d];
+            if (e < 0) {
+                continue;
+            }
+            int *votes = &event_source[result.event_count + e];
+            if (*votes == 0) {
+                event_source[e] = q;
+            }
+            *votes += event_source[e] == q ? 1 : -1;
+        }
+        for (int e = 0; scored && e < result.event_count; e++) {
+            event_source[result.event_count + e] = 0;
+        }
+        for (int d = 0; scored && d < count; d++) {
+            int e = result.detection_event[d];
+            if (e >= 0 && detection_quake[d] == event_source[e]) {
+                event_source[result.event_count + e]++;
+            }
+        }
+
+        createStationPool(&pool, availableCores());
+        for (int e = 0; e < result.event_count; e++) {
+            double located = monotonicSeconds();
+            locateNetworkEvent(&table, &network, &result, e, &pool);
+            located = monotonicSeconds() - located;
+            total += located;
+            slowest = located > slowest ? located : slowest;
+
+            if (!scored) {
+                continue;
+            }
+            const NetworkEvent *event = &result.events[e];
+            int q = event_source[e];
+            if (q < 0) {
+                spurious++;
+            } else if (quake_picks[earthquake_count + q]++ > 0) {
+                extra++;
+                split += quake_picks[earthquake_count + q] == 2;
+            } else {
+                double epicenter = greatCircleKm(event->latitude, event->longitude, truth[4 * q], truth[4 * q + 1]);
+                double depth = fabs(truth[4 * q + 2] - event->depth);
+                errors[matched] = epicenter;
+                errors[result.event_count + matched++] = depth;
+                if (event_source[result.event_count + e] * 10 >= event->station_count * 9) {
+                    errors[2 * result.event_count + clean] = epicenter;
+                    errors[3 * result.event_count + clean++] = depth;
+                }
+            }
+        }
+        destroyStationPool(&pool);
+        for (int q = 0; scored && q < earthquake_count; q++) {
+            if (quake_picks[q] >= ASSOCIATION_MIN_STATIONS) {
+                detectable++;
+                missed += quake_picks[earthquake_count + q] == 0;
+            }
+        }
+
+        printf("%d simulated earthquakes, %d station detections (one alert each without association).\n",
+               earthquake_count, count);
+        printAssociatedEvents(&network, &result, 10);
+        printf("Association time: %.2f ms\n", elapsed * 1e3);
+        printf("Location time per event: mean %.2f ms, max %.2f ms (budget %.0f ms)\n",
+               total / (result.event_count ? result.event_count : 1) * 1e3, slowest * 1e3, LOCATE_LATENCY_BUDGET_MS);
+        if (result.event_count > 0) {
+            int64_t origin_ns = llround(result.events[0].origin_time * NS_PER_SECOND);
+            int first;
+            int window = findNetworkEventsInRange(&network, origin_ns, origin_ns + 300 * NS_PER_SECOND, &first);
+            printf("Station events within 5 minutes after Network Event 1: %d\n", window);
+        }
+        printf("Event count: %d events for %d detectable earthquakes; %d split into %d extra events, %d missed, %d spurious\n",
+               result.event_count, detectable, split, extra, missed, spurious);
+        if (matched > 0) {
+            qsort(errors, matched, sizeof(double), compareDoubles);
+            qsort(errors + result.event_count, matched, sizeof(double), compareDoubles);
+            printf("Epicenter error: median %.1f km, 90th percentile %.1f km; depth error median %.1f km (%d events matched)\n",
+                   errors[matched / 2], errors[matched * 9 / 10], errors[result.event_count + matched / 2], matched);
+        }
+        if (clean > 0) {
+            double *epicenter = errors + 2 * result.event_count, *depth = errors + 3 * result.event_count;
+            qsort(epicenter, clean, sizeof(double), compareDoubles);
+            qsort(depth, clean, sizeof(double), compareDoubles);
+            printf("  of which %d with picks from one earthquake: median %.1f km, 90th percentile %.1f km; depth error median %.1f km\n",
+                   clean, epicenter[clean / 2], epicenter[clean * 9 / 10], depth[clean / 2]);
+        }
+        free(errors);
+        free(event_source);
+        free(quake_picks);
+        free(detection_quake);
+        freeAssociationResult(&result);
+    }
+    free(detections);
+    free(truth);
+    free(quake_rows_end);
+    freeTravelTimeTable(&table);
+    freeSeismicNetwork(&network);
+}
+
+// First arrival in a flat layered model: the direct wave (straight path at the mean
+// velocity above the source) or the fastest head wave along a deeper, faster layer top,
+// where one exists. Curvature is ignored, which is adequate at regional distances.
+double layeredTravelTime(double distance, double depth) {
+    double vertical = 0;
+    for (int i = 0; i < VELOCITY_LAYERS; i++) {
+        double bottom = i + 1 < VELOCITY_LAYERS ? velocityModel[i + 1].top_km : depth;
+        double portion = (bottom < depth ? bottom : depth) - velocityModel[i].top_km;
+        if (portion > 0) {
+            vertical += portion / velocityModel[i].velocity;
+        }
+    }
+    double average = depth > 0 ? depth / vertical : velocityModel[0].velocity;
+    double best = sqrt(distance * distance + depth * depth) / average;
+
+    for (int k = 1; k < VELOCITY_LAYERS; k++) {
+        double refractor = velocityModel[k].velocity;
+        bool fastest = velocityModel[k].top_km > depth;
+        for (int i = 0; i < k && fastest; i++) {
+            fastest = velocityModel[i].velocity < refractor;
+        }
+        if (!fastest) {
+            continue;
+        }
+        double delay = 0, offset = 0;
+        for (int i = 0; i < k; i++) {
+            double top = velocityModel[i].top_km, bottom = velocityModel[i + 1].top_km;
+            double above = (bottom < depth ? bottom : depth) - top;
+            double below = bottom - (top > depth ? top : depth);
+            double path = (above > 0 ? above : 0) + 2 * (below > 0 ? below : 0);
+            double sine = velocityModel[i].velocity / refractor;
+            double cosine = sqrt(1 - sine * sine);
+            delay += path * cosine / velocityModel[i].velocity;
+            offset += path * sine / cosine;
+        }
+        if (distance >= offset && distance / refractor + delay < best) {
+            best = distance / refractor + delay;
+        }
+    }
+    return best;
+}
+
+bool buildTravelTimeTable(TravelTimeTable *table) {
+    double max_chord = 2 * sin(LOCATE_MAX_DISTANCE_KM / EARTH_RADIUS_KM / 2);
+    table->depth_count = (int)(LOCATE_MAX_DEPTH_KM / LOCATE_DEPTH_STEP_KM) + 1;
+    table->chord_count = LOCATE_CHORD_SAMPLES;
+    table->depth_step = LOCATE_DEPTH_STEP_KM;
+    table->chord_step = max_chord / (LOCATE_CHORD_SAMPLES - 1);
+    table->times = malloc((size_t)table->depth_count * table->chord_count * sizeof(float));
+    if (table->times == NULL) {
+        return false;
+    }
+    for (int r = 0; r < table->depth_count; r++) {
+        for (int c = 0; c < table->chord_count; c++) {
+            double chord = c * table->chord_step;
+            double distance = 2 * EARTH_RADIUS_KM * asin(chord / 2 > 1 ? 1 : chord / 2);
+            table->times[(size_t)r * table->chord_count + c] = (float)layeredTravelTime(distance, r * table->depth_step);
+        }
+    }
+    return true;
+}
+
+void freeTravelTimeTable(TravelTimeTable *table) {
+    free(table->times);
+    table->times = NULL;
+}
+
+double lookupTravelTime(const TravelTimeTable *table, double chord, double depth) {
+    double column = chord / table->chord_step;
+    double row = depth / table->depth_step;
+    column = column < table->chord_count - 1.000001 ? column : table->chord_count - 1.000001;
+    row = row < table->depth_count - 1.000001 ? (row > 0 ? row : 0) : table->depth_count - 1.000001;
+    int c = (int)column, r = (int)row;
+    const float *upper = table->times + (size_t)r * table->chord_count;
+    const float *lower = upper + table->chord_count;
+    double near = upper[c] + (column - c) * (upper[c + 1] - upper[c]);
+    double far = lower[c] + (column - c) * (lower[c + 1] - lower[c]);
+    return near + (row - r) * (far - near);
+}
+
+// Clipped RMS misfit of one trial hypocenter. The origin time minimising the L2 misfit
+// is the weighted mean residual, so it is solved for rather than searched; it is then
+// re-estimated from the residuals within LOCATE_CLIP_S of the first mean, and residuals
+// are capped at LOCATE_CLIP_S, so a stray pick cannot drag the search into a wrong basin.
+// The loops have no cross-iteration dependence, but gcc only vectorises all four with
+// -O3 -fno-math-errno -fno-trapping-math: by default the errno path of sqrt keeps the
+// travel-time loop scalar, and the possibly trapping compare the clipping loop.
+double hypocenterMisfit(const LocatorJob *job, const double *trial, double depth, double *residuals, double *origin) {
+    const TravelTimeTable *table = job->table;
+    const double *restrict x = job->x;
+    const double *restrict y = job->y;
+    const double *restrict z = job->z;
+    const double *restrict arrival = job->arrival;
+    const double *restrict weight = job->weight;
+    double row = depth / table->depth_step;
+    row = row < table->depth_count - 1.000001 ? (row > 0 ? row : 0) : table->depth_count - 1.000001;
+    int r = (int)row;
+    double depth_weight = row - r;
+    const float *restrict upper = table->times + (size_t)r * table->chord_count;
+    const float *restrict lower = upper + table->chord_count;
+    double scale = 1.0 / table->chord_step, limit = table->chord_count - 1.000001;
+    int n = job->pick_count;
+
+    for (int i = 0; i < n; i++) {
+        double squared = 2 - 2 * (trial[0] * x[i] + trial[1] * y[i] + trial[2] * z[i]);
+        double column = sqrt(squared > 0 ? squared : 0) * scale;
+        column = column < limit ? column : limit;
+        int c = (int)column;
+        double w = column - c;
+        double near = upper[c] + w * (upper[c + 1] - upper[c]);
+        double far = lower[c] + w * (lower[c + 1] - lower[c]);
+        residuals[i] = arrival[i] - (near + depth_weight * (far - near));
+    }
+
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += weight[i] * residuals[i];
+    }
+    double mean = sum / job->weight_sum;
+
+    double kept_sum = 0, kept_weight = 0;
+    for (int i = 0; i < n; i++) {
+        double inside = weight[i] * (fabs(residuals[i] - mean) <= LOCATE_CLIP_S);
+        kept_sum += inside * residuals[i];
+        kept_weight += inside;
+    }
+    mean = kept_weight > 0 ? kept_sum / kept_weight : mean;
+
+    double squares = 0;
+    for (int i = 0; i < n; i++) {
+        double deviation = fabs(residuals[i] - mean);
+        deviation = deviation < LOCATE_CLIP_S ? deviation : LOCATE_CLIP_S;
+        squares += weight[i] * deviation * deviation;
+    }
+    *origin = mean;
+    return sqrt(squares / job->weight_sum);
+}
+
+void locateRowTask(void *context, PoolWorker *worker, int row) {
+    LocatorJob *job = context;
+    LocatorBest *best = &job->best[worker->id];
+    double *residuals = job->residuals + (size_t)worker->id * job->pick_count;
+    double latitude = job->latitude0 + row * job->step_deg;
+    if (latitude < -90 || latitude > 90) {
+        return;
+    }
+    for (int column = 0; column < job->longitude_nodes; column++) {
+        double longitude = job->longitude0 + column * job->longitude_step_deg;
+        double trial[3];
+        trial[0] = cos(latitude * M_PI / 180.0) * cos(longitude * M_PI / 180.0);
+        trial[1] = cos(latitude * M_PI / 180.0) * sin(longitude * M_PI / 180.0);
+        trial[2] = sin(latitude * M_PI / 180.0);
+        for (int d = 0; d < job->depth_nodes; d++) {
+            double depth = job->depth0 + d * job->depth_step;
+            double origin;
+            if (depth < 0 || depth > LOCATE_MAX_DEPTH_KM) {
+                continue;
+            }
+            double misfit = hypocenterMisfit(job, trial, depth, residuals, &origin);
+            if (misfit < best->misfit) {
+                best->misfit = misfit;
+                best->latitude = latitude;
+                best->longitude = longitude;
+                best->depth = depth;
+                best->origin = origin;
+            }
+        }
+    }
+}
+
+// Scans a latitude x longitude x depth grid centred on center, one latitude row per pool
+// task, and reduces the per-worker bests. Longitude steps are widened by 1/cos(latitude)
+// so the grid covers the same ground near the poles. Ties go to the southernmost, then
+// westernmost, then shallowest node, so the answer does not depend on the worker count.
+LocatorBest gridSearchHypocenter(LocatorJob *job, StationPool *pool, LocatorBest center,
+                                 double span_deg, double step_deg, double depth_span, double depth_step) {
+    int half = (int)(span_deg / step_deg + 0.5);
+    int depth_half = (int)(depth_span / depth_step + 0.5);
+    double parallel = cos(center.latitude * M_PI / 180.0);
+    job->step_deg = step_deg;
+    job->longitude_step_deg = step_deg / (parallel > 0.05 ? parallel : 0.05);
+    job->latitude0 = center.latitude - half * step_deg;
+    job->longitude0 = center.longitude - half * job->longitude_step_deg;
+    job->latitude_nodes = job->longitude_nodes = 2 * half + 1;
+    job->depth_step = depth_step;
+    job->depth0 = center.depth - depth_half * depth_step;
+    job->depth_nodes = 2 * depth_half + 1;
+    for (int w = 0; w < pool->worker_count; w++) {
+        job->best[w].misfit = INFINITY;
+    }
+
+    runStationPool(pool, job->latitude_nodes, locateRowTask, job, NULL);
+
+    LocatorBest best = job->best[0];
+    for (int w = 1; w < pool->worker_count; w++) {
+        const LocatorBest *other = &job->best[w];
+        if (other->misfit < best.misfit ||
+            (other->misfit == best.misfit &&
+             (other->latitude < best.latitude || (other->latitude == best.latitude &&
+              (other->longitude < best.longitude || (other->longitude == best.longitude && other->depth < best.depth)))))) {
+            best = *other;
+        }
+    }
+    return best.misfit < INFINITY ? best : center;
+}
+
+LocatorBest refineHypocenter(LocatorJob *job, StationPool *pool, LocatorBest best, double step_deg, double depth_step) {
+    for (int pass = 0; pass < LOCATE_REFINEMENTS; pass++) {
+        best = gridSearchHypocenter(job, pool, best, 2 * step_deg, step_deg / 4, 2 * depth_step, depth_step / 4);
+        step_deg /= 4;
+        depth_step /= 4;
+    }
+    return best;
+}
+
+// Locates an associated event from its picks: a coarse grid around the first-arriving
+// station, LOCATE_REFINEMENTS finer grids around each best node, then one relocation with
+// picks more than LOCATE_OUTLIER_S from the prediction dropped (false triggers that the
+// association let through).
+bool locateNetworkEvent(const TravelTimeTable *table, SeismicNetwork *network, AssociationResult *result, int e, StationPool *pool) {
+    NetworkEvent *event = &result->events[e];
+    LocatorJob job;
+    int n = event->station_count;
+    memset(&job, 0, sizeof(job));
+    job.table = table;
+    job.pick_count = n;
+    job.x = malloc(((size_t)5 + pool->worker_count) * (n + 4) * sizeof(double));
+    if (job.x == NULL) {
+        return false;
+    }
+    job.y = job.x + (n + 4);
+    job.z = job.y + (n + 4);
+    job.arrival = job.z + (n + 4);
+    job.weight = job.arrival + (n + 4);
+    job.residuals = job.weight + (n + 4);
+
+    double reference = result->arrival_times[event->first_station];
+    double centroid[3] = {0, 0, 0};
+    for (int i = 0; i < n; i++) {
+        double vector[3];
+        stationUnitVector(&network->stations[result->stations[event->first_station + i]], vector);
+        job.x[i] = vector[0];
+        job.y[i] = vector[1];
+        job.z[i] = vector[2];
+        job.arrival[i] = result->arrival_times[event->first_station + i] - reference;
+        job.weight[i] = 1;
+        centroid[0] += vector[0];
+        centroid[1] += vector[1];
+        centroid[2] += vector[2];
+    }
+    job.weight_sum = n;
+
+    // The coarse grid is centred on the station centroid rather than the seed station,
+    // which may be a false trigger.
+    LocatorBest start = {INFINITY, atan2(centroid[2], hypot(centroid[0], centroid[1])) * 180.0 / M_PI,
+                         atan2(centroid[1], centroid[0]) * 180.0 / M_PI, LOCATE_MAX_DEPTH_KM / 2, 0};
+    LocatorBest best = gridSearchHypocenter(&job, pool, start, LOCATE_SPAN_DEG, LOCATE_COARSE_STEP_DEG,
+                                            LOCATE_MAX_DEPTH_KM / 2, LOCATE_COARSE_DEPTH_STEP_KM);
+    best = refineHypocenter(&job, pool, best, LOCATE_COARSE_STEP_DEG, LOCATE_COARSE_DEPTH_STEP_KM);
+
+    double trial[3], origin;
+    trial[0] = cos(best.latitude * M_PI / 180.0) * cos(best.longitude * M_PI / 180.0);
+    trial[1] = cos(best.latitude * M_PI / 180.0) * sin(best.longitude * M_PI / 180.0);
+    trial[2] = sin(best.latitude * M_PI / 180.0);
+    hypocenterMisfit(&job, trial, best.depth, job.residuals, &origin);
+    int kept = 0;
+    for (int i = 0; i < n; i++) {
+        kept += fabs(job.residuals[i] - origin) <= LOCATE_OUTLIER_S;
+    }
+    if (kept < n && kept >= ASSOCIATION_MIN_STATIONS) {
+        for (int i = 0; i < n; i++) {
+            job.weight[i] = fabs(job.residuals[i] - origin) <= LOCATE_OUTLIER_S;
+        }
+        job.weight_sum = kept;
+        best = gridSearchHypocenter(&job, pool, best, 2 * LOCATE_COARSE_STEP_DEG, LOCATE_COARSE_STEP_DEG,
+                                    2 * LOCATE_COARSE_DEPTH_STEP_KM, LOCATE_COARSE_DEPTH_STEP_KM);
+        best = refineHypocenter(&job, pool, best, LOCATE_COARSE_STEP_DEG, LOCATE_COARSE_DEPTH_STEP_KM);
+    }
+
+    event->latitude = (float)best.latitude;
+    event->longitude = (float)(best.longitude > 180 ? best.longitude - 360 : (best.longitude < -180 ? best.longitude + 360 : best.longitude));
+    event->depth = (float)best.depth;
+    event->origin_time = reference + best.origin;
+    event->rms = (float)best.misfit;
+    event->located = true;
+    free(job.x);
+    return true;
+}
+
+int compareDoubles(const void *a, const void *b) {
+    double left = *(const double *)a, right = *(const double *)b;
+    return (left > right) - (left < right);
+}
+
+// Adds (delta = 1) or removes (delta = -1) one magnitude. Every term is a count or a sum,
+// so removal is exact and costs the same as insertion.
+void updateMagnitudeStats(MagnitudeStats *stats, float magnitude, int delta) {
+    double scaled = floor(((double)magnitude - GR_MIN_MAGNITUDE) / GR_BIN_WIDTH + GR_BIN_EPSILON);
+    int bin = scaled < 0 ? 0 : (scaled >= GR_BINS ? GR_BINS - 1 : (int)scaled);
+    stats->bins[bin] += delta;
+    stats->count += delta;
+    if (magnitude >= GR_COMPLETENESS_MAGNITUDE) {
+        double excess = (double)magnitude - GR_COMPLETENESS_MAGNITUDE;
+        stats->complete_count += delta;
+        stats->excess_sum += delta * excess;
+        stats->excess_squares += delta * excess * excess;
+    }
+}
+
+int magnitudeRegion(float latitude, float longitude) {
+    int row = (int)floor((latitude + 90.0) / GR_REGION_DEG);
+    int column = (int)floor((longitude + 180.0) / GR_REGION_DEG);
+    row = row < 0 ? 0 : (row >= 180 / GR_REGION_DEG ? 180 / GR_REGION_DEG - 1 : row);
+    column = column < 0 ? 0 : (column >= 360 / GR_REGION_DEG ? 360 / GR_REGION_DEG - 1 : column);
+    return row * (360 / GR_REGION_DEG) + column;
+}
+
+// Keeps the station, region and network statistics in step with the event table.
+void updateEventMagnitude(SeismicNetwork *network, int station, float latitude, float longitude, float magnitude, int delta) {
+    updateMagnitudeStats(&network->stations[station].magnitudes, magnitude, delta);
+    updateMagnitudeStats(&network->region_magnitudes[magnitudeRegion(latitude, longitude)], magnitude, delta);
+    updateMagnitudeStats(&network->magnitudes, magnitude, delta);
+}
+
+// Cumulative count N(>= magnitude) from the histogram, exact when magnitude falls on a
+// bin edge.
+long countMagnitudesAtLeast(const MagnitudeStats *stats, float magnitude) {
+    double scaled = ceil(((double)magnitude - GR_MIN_MAGNITUDE) / GR_BIN_WIDTH - GR_BIN_EPSILON);
+    long count = 0;
+    for (int bin = scaled < 0 ? 0 : (int)fmin(scaled, GR_BINS); bin < GR_BINS; bin++) {
+        count += stats->bins[bin];
+    }
+    return count;
+}
+
+// Aki's maximum-likelihood b-value with Utsu's correction for magnitudes reported to
+// GR_BIN_WIDTH, the Shi & Bolt standard error, and a 95% interval. The a-value is
+// log10 N(>= Mc) + b Mc for the events recorded so far; its error combines the Poisson
+// error of the count with the b-value error.
+bool fitGutenbergRichter(const MagnitudeStats *stats, GutenbergRichterFit *fit) {
+    long n = stats->complete_count;
+    memset(fit, 0, sizeof(*fit));
+    fit->count = n;
+    fit->completeness = GR_COMPLETENESS_MAGNITUDE;
+    if (n < GR_MIN_FIT_EVENTS) {
+        return false;
+    }
+    double mean = stats->excess_sum / n;
+    if (mean + GR_BIN_WIDTH / 2 <= 0) {
+        return false;
+    }
+    double spread = stats->excess_squares - n * mean * mean;
+    fit->b_value = M_LOG10E / (mean + GR_BIN_WIDTH / 2);
+    fit->b_error = 2.30 * fit->b_value * fit->b_value * sqrt((spread > 0 ? spread : 0) / ((double)n * (n - 1)));
+    fit->b_lower = fit->b_value - 1.96 * fit->b_error;
+    fit->b_upper = fit->b_value + 1.96 * fit->b_error;
+    fit->a_value = log10((double)n) + fit->b_value * fit->completeness;
+    fit->a_error = sqrt(1.0 / (n * M_LN10 * M_LN10) + pow(fit->completeness * fit->b_error, 2));
+    fit->valid = true;
+    return true;
+}
+
+double expectedEventsAtLeast(const GutenbergRichterFit *fit, double magnitude) {
+    return fit->valid ? pow(10.0, fit->a_value - fit->b_value * magnitude) : 0;
+}
+
+void printGutenbergRichterFit(const char *label, const GutenbergRichterFit *fit) {
+    if (!fit->valid) {
+        printf("%s: too few events above M %.1f for a fit (%ld)\n", label, fit->completeness, fit->count);
+        return;
+    }
+    printf("%s: %ld events >= M %.1f, b = %.3f [%.3f, %.3f], a = %.2f +/- %.2f, expected M7+: %.2f\n", label,
+           fit->count, fit->completeness, fit->b_value, fit->b_lower, fit->b_upper, fit->a_value, fit->a_error,
+           expectedEventsAtLeast(fit, 7.0));
+}
+
+// Records a synthetic catalogue whose magnitudes follow Gutenberg-Richter with b = 0.8
+// north of the equator and 1.2 south of it, rounded to GR_BIN_WIDTH, then reads the
+// fits back from the incremental statistics without touching the event table.
+void runGutenbergRichterDemo(int station_count, int event_count) {
+    SeismicNetwork network;
+    memset(&network, 0, sizeof(network));
+    for (int i = 0; i < station_count; i++) {
+        char location[50];
+        sprintf(location, "Station %d Location", i + 1);
+        addSeismicStation(&network, i + 1, location);
+    }
+    if (network.station_count == 0) {
+        return;
+    }
+    placeStationsOnSphere(&network);
+    srand(2025);
+
+    int64_t start_ns = civilTimestamp(2025, 1, 1, 0, 0, 0);
+    double started = monotonicSeconds();
+    for (int e = 0; e < event_count; e++) {
+        SeismicEvent event;
+        int station = rand() % network.station_count;
+        double uniform = (rand() + 1.0) / ((double)RAND_MAX + 1.0);
+        event.latitude = network.stations[station].latitude;
+        event.longitude = network.stations[station].longitude;
+        event.depth = rand() % 100;
+        double b = event.latitude >= 0 ? 0.8 : 1.2;
+        double magnitude = GR_COMPLETENESS_MAGNITUDE - GR_BIN_WIDTH / 2 - log10(uniform) / b;
+        event.magnitude = (float)(round(magnitude / GR_BIN_WIDTH) * GR_BIN_WIDTH);
+        event.timestamp_ns = start_ns + (int64_t)e * 60 * NS_PER_SECOND;
+        event.event_detected = true;
+        recordSeismicEvent(&network, station, &event);
+    }
+    double elapsed = monotonicSeconds() - started;
+
+    GutenbergRichterFit fit;
+    printf("%d events recorded in %.2f ms (%.0f ns per event, statistics included).\n", event_count, elapsed * 1e3,
+           elapsed * 1e9 / (event_count ? event_count : 1));
+    fitGutenbergRichter(&network.magnitudes, &fit);
+    printGutenbergRichterFit("Network", &fit);
+    printf("Events of Magnitude 6.0 or Greater: %ld\n", countMagnitudesAtLeast(&network.magnitudes, 6.0f));
+
+    int busiest_north = -1, busiest_south = -1;
+    for (int r = 0; r < GR_REGIONS; r++) {
+        bool north = r >= GR_REGIONS / 2;
+        int *busiest = north ? &busiest_north : &busiest_south;
+        if (*busiest < 0 || network.region_magnitudes[r].count > network.region_magnitudes[*busiest].count) {
+            *busiest = r;
+        }
+    }
+    int regions[2] = {busiest_north, busiest_south};
+    for (int i = 0; i < 2; i++) {
+        char label[96];
+        int r = regions[i], columns = 360 / GR_REGION_DEG;
+        snprintf(label, sizeof(label), "Region lat %+d..%+d, long %+d..%+d (true b %.1f)",
+                 r / columns * GR_REGION_DEG - 90, (r / columns + 1) * GR_REGION_DEG - 90,
+                 r % columns * GR_REGION_DEG - 180, (r % columns + 1) * GR_REGION_DEG - 180, i == 0 ? 0.8 : 1.2);
+        fitGutenbergRichter(&network.region_magnitudes[r], &fit);
+        printGutenbergRichterFit(label, &fit);
+    }
+    fitGutenbergRichter(&network.stations[0].magnitudes, &fit);
+    printGutenbergRichterFit("Station 1", &fit);
+    freeSeismicNetwork(&network);
+}
+
+// Inserts every reported tenth as the float a catalogue would store, checks that each
+// lands in its own bin and that N(>= m) counts it, then removes them all again.
+bool checkMagnitudeBins(void) {
+    MagnitudeStats stats;
+    int failures = 0;
+    memset(&stats, 0, sizeof(stats));
+    for (int k = 0; k < GR_BINS; k++) {
+        updateMagnitudeStats(&stats, (float)(GR_MIN_MAGNITUDE + k * GR_BIN_WIDTH), 1);
+    }
+    for (int k = 0; k < GR_BINS; k++) {
+        float magnitude = (float)(GR_MIN_MAGNITUDE + k * GR_BIN_WIDTH);
+        long at_least = countMagnitudesAtLeast(&stats, magnitude);
+        if (stats.bins[k] != 1 || at_least != GR_BINS - k) {
+            printf("Magnitude %.1f: bin %d holds %u, N(>= m) is %ld (expected 1 and %d).\n", magnitude, k,
+                   stats.bins[k], at_least, GR_BINS - k);
+            failures++;
+        }
+    }
+    for (int k = 0; k < GR_BINS; k++) {
+        updateMagnitudeStats(&stats, (float)(GR_MIN_MAGNITUDE + k * GR_BIN_WIDTH), -1);
+    }
+    for (int k = 0; k < GR_BINS; k++) {
+        failures += stats.bins[k] != 0;
+    }
+    if (stats.count != 0 || stats.complete_count != 0 || fabs(stats.excess_sum) > 1e-9 || fabs(stats.excess_squares) > 1e-9) {
+        printf("Statistics did not return to empty after removing every magnitude.\n");
+        failures++;
+    }
+    printf("Magnitude bin check %s: %d tenths from %.1f to %.1f.\n", failures ? "FAILED" : "passed", GR_BINS,
+           GR_MIN_MAGNITUDE, GR_MIN_MAGNITUDE + (GR_BINS - 1) * GR_BIN_WIDTH);
+    return failures == 0;
+}
+
+// Compares both range queries against a linear scan of the table over random windows,
+// including empty and inverted ones. Returns the number of mismatching queries.
+int checkRangeQueries(SeismicNetwork *network, int trials) {
+    SeismicEventTable *table = &network->events;
+    int64_t start_ns = civilTimestamp(2025, 3, 1, 0, 0, 0);
+    int failures = 0;
+    for (int t = 0; t < trials; t++) {
+        int station = rand() % network->station_count;
+        int64_t from_ns = start_ns + (int64_t)(rand() % 1100 - 50) * NS_PER_SECOND;
+        int64_t to_ns = from_ns + (int64_t)(rand() % 200 - 20) * NS_PER_SECOND;
+        int first, station_first;
+        int count = findNetworkEventsInRange(network, from_ns, to_ns, &first);
+        int station_count = findStationEventsInRange(network, station, from_ns, to_ns, &station_first);
+        int expected = 0, station_expected = 0;
+        for (int row = 0; row < table->count; row++) {
+            bool inside = table->timestamp_ns[row] >= from_ns && table->timestamp_ns[row] < to_ns;
+            expected += inside;
+            station_expected += inside && table->station[row] == station;
+        }
+        bool matches = count == expected && station_count == station_expected;
+        for (int i = first; i < first + count && matches; i++) {
+            int64_t timestamp_ns = table->timestamp_ns[table->time_rows[i]];
+            matches = timestamp_ns >= from_ns && timestamp_ns < to_ns;
+        }
+        for (int i = station_first; i < station_first + station_count && matches; i++) {
+            int row = table->station_rows[i];
+            matches = table->station[row] == station && table->timestamp_ns[row] >= from_ns &&
+                      table->timestamp_ns[row] < to_ns;
+        }
+        if (!matches) {
+            printf("Range [%lld, %lld) s: network %d rows (expected %d), station %d %d rows (expected %d).\n",
+                   (long long)((from_ns - start_ns) / NS_PER_SECOND), (long long)((to_ns - start_ns) / NS_PER_SECOND),
+                   count, expected, station, station_count, station_expected);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// Records events out of time order with repeated timestamps, then checks the range
+// queries on the fresh index, after resetStationData drops a station, and after more
+// events arrive for the emptied station.
+bool checkEventRanges(void) {
+    SeismicNetwork network;
+    memset(&network, 0, sizeof(network));
+    for (int s = 0; s < 8; s++) {
+        char location[50];
+        sprintf(location, "Station %d Location", s + 1);
+        addSeismicStation(&network, s + 1, location);
+    }
+    int64_t start_ns = civilTimestamp(2025, 3, 1, 0, 0, 0);
+    SeismicEvent event = {0};
+    int failures = 0;
+    for (int round = 0; round < 2; round++) {
+        for (int e = 0; e < 2000; e++) {
+            int station = round == 0 ? rand() % network.station_count : 3;
+            event.magnitude = (float)(rand() % 60) / 10.0f + 2.0f;
+            event.timestamp_ns = start_ns + (int64_t)(rand() % 1000) * NS_PER_SECOND;
+            recordSeismicEvent(&network, station, &event);
+            if (round == 1 && e == 999) {
+                failures += checkRangeQueries(&network, 1000);
+            }
+        }
+        failures += checkRangeQueries(&network, 1000);
+        if (round == 0) {
+            resetStationData(&network, 3);
+            failures += checkRangeQueries(&network, 1000);
+        }
+    }
+    printf("Event range check %s: %d queries over %d events on %d stations.\n", failures ? "FAILED" : "passed",
+           4000, network.events.count, network.station_count);
+    freeSeismicNetwork(&network);
+    return failures == 0;
+}
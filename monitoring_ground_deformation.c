@@ -6,14 +6,60 @@
 #define THRESHOLD 0.05
 #define SAMPLING_INTERVAL 1 
 #define FILTER_WINDOW 5
+#define TREND_WINDOW 20
+#define ROLLUP_LEVELS 4
+#define ROLLUP_CAPACITY 1440
 
 typedef struct {
     double timestamp;
     double displacement;
 } GroundDeformationSample;
 
+// Additive least-squares sums: two aggregates over disjoint time ranges merge by
+// adding fields, and mean and slope can be derived from any aggregate. Time moments are
+// taken relative to startTime so epoch-scale timestamps do not cancel in the slope.
+typedef struct {
+    double startTime;
+    long count;
+    double min;
+    double max;
+    double sumX;
+    double sumT;
+    double sumTT;
+    double sumTX;
+} DeformationAggregate;
+
+// Sliding-window least-squares fit maintained in O(1) per sample: the newest sample is
+// added to the sums and the one falling out of the window is subtracted. Time moments
+// are relative to origin, which follows the oldest sample in the window.
+typedef struct {
+    GroundDeformationSample window[TREND_WINDOW];
+    int start;
+    int count;
+    double origin;
+    double sumT;
+    double sumX;
+    double sumTT;
+    double sumTX;
+} TrendEstimator;
+
+// evictedBefore is the start of the oldest retained bucket once the ring has started
+// overwriting, and -INFINITY until then.
+typedef struct {
+    double period;
+    DeformationAggregate records[ROLLUP_CAPACITY];
+    int first;
+    int count;
+    double evictedBefore;
+    DeformationAggregate open;
+    int hasOpen;
+} RollupLevel;
+
 GroundDeformationSample data[MAX_SAMPLES];
 int dataIndex = 0;
+TrendEstimator trendEstimator;
+RollupLevel rollups[ROLLUP_LEVELS];
+const double rollupPeriods[ROLLUP_LEVELS] = {1.0, 60.0, 3600.0, 86400.0};
 
 double getSensorReading() {
     return (rand() % 100) / 100.0;
@@ -23,6 +69,209 @@ void calibrateSensor() {
     printf("Calibrating sensor...\n");
 }
 
+double leastSquaresSlope(double n, double sumT, double sumX, double sumTT, double sumTX) {
+    double denominator = n * sumTT - sumT * sumT;
+    if (n < 2 || fabs(denominator) < 1e-12) {
+        return 0;
+    }
+    return (n * sumTX - sumT * sumX) / denominator;
+}
+
+// Re-expresses time moments taken relative to one origin relative to an origin shift
+// earlier, i.e. t' = t + shift for each of the count samples.
+void shiftTimeMoments(double shift, double count, double sumX, double *sumT, double *sumTT, double *sumTX) {
+    *sumTT += 2 * shift * *sumT + count * shift * shift;
+    *sumTX += shift * sumX;
+    *sumT += count * shift;
+}
+
+void updateTrendEstimator(TrendEstimator *trend, GroundDeformationSample sample) {
+    if (trend->count == 0) {
+        trend->origin = sample.timestamp;
+    }
+    if (trend->count == TREND_WINDOW) {
+        GroundDeformationSample old = trend->window[trend->start];
+        double t = old.timestamp - trend->origin;
+        trend->sumT -= t;
+        trend->sumX -= old.displacement;
+        trend->sumTT -= t * t;
+        trend->sumTX -= t * old.displacement;
+        trend->start = (trend->start + 1) % TREND_WINDOW;
+        trend->count--;
+
+        double origin = trend->window[trend->start].timestamp;
+        shiftTimeMoments(trend->origin - origin, trend->count, trend->sumX, &trend->sumT, &trend->sumTT, &trend->sumTX);
+        trend->origin = origin;
+    }
+    trend->window[(trend->start + trend->count) % TREND_WINDOW] = sample;
+    trend->count++;
+    double t = sample.timestamp - trend->origin;
+    trend->sumT += t;
+    trend->sumX += sample.displacement;
+    trend->sumTT += t * t;
+    trend->sumTX += t * sample.displacement;
+}
+
+double displacementRate(TrendEstimator *trend) {
+    return leastSquaresSlope(trend->count, trend->sumT, trend->sumX, trend->sumTT, trend->sumTX);
+}
+
+void resetAggregate(DeformationAggregate *aggregate, double startTime) {
+    aggregate->startTime = startTime;
+    aggregate->count = 0;
+    aggregate->min = INFINITY;
+    aggregate->max = -INFINITY;
+    aggregate->sumX = 0;
+    aggregate->sumT = 0;
+    aggregate->sumTT = 0;
+    aggregate->sumTX = 0;
+}
+
+// An empty target adopts the source's origin, so a query result starting far before
+// its first bucket still keeps its moments small.
+void mergeAggregate(DeformationAggregate *into, const DeformationAggregate *from) {
+    if (into->count == 0) {
+        into->startTime = from->startTime;
+    }
+    double sumT = from->sumT;
+    double sumTT = from->sumTT;
+    double sumTX = from->sumTX;
+    shiftTimeMoments(from->startTime - into->startTime, from->count, from->sumX, &sumT, &sumTT, &sumTX);
+    into->count += from->count;
+    into->min = fmin(into->min, from->min);
+    into->max = fmax(into->max, from->max);
+    into->sumX += from->sumX;
+    into->sumT += sumT;
+    into->sumTT += sumTT;
+    into->sumTX += sumTX;
+}
+
+double aggregateMean(const DeformationAggregate *aggregate) {
+    return aggregate->count > 0 ? aggregate->sumX / aggregate->count : 0;
+}
+
+double aggregateSlope(const DeformationAggregate *aggregate) {
+    return leastSquaresSlope(aggregate->count, aggregate->sumT, aggregate->sumX, aggregate->sumTT, aggregate->sumTX);
+}
+
+void initializeRollups() {
+    for (int level = 0; level < ROLLUP_LEVELS; level++) {
+        rollups[level].period = rollupPeriods[level];
+        rollups[level].first = 0;
+        rollups[level].count = 0;
+        rollups[level].evictedBefore = -INFINITY;
+        rollups[level].hasOpen = 0;
+    }
+}
+
+// Every level is fed directly from raw samples, so each open bucket is always complete
+// up to the latest sample. Closed buckets go into a fixed ring per level; the oldest
+// record is overwritten once a level holds ROLLUP_CAPACITY buckets.
+void addToRollups(GroundDeformationSample sample) {
+    for (int level = 0; level < ROLLUP_LEVELS; level++) {
+        RollupLevel *rollup = &rollups[level];
+        double bucketStart = floor(sample.timestamp / rollup->period) * rollup->period;
+
+        if (rollup->hasOpen && rollup->open.startTime != bucketStart) {
+            int slot = (rollup->first + rollup->count) % ROLLUP_CAPACITY;
+            rollup->records[slot] = rollup->open;
+            if (rollup->count < ROLLUP_CAPACITY) {
+                rollup->count++;
+            } else {
+                rollup->first = (rollup->first + 1) % ROLLUP_CAPACITY;
+                rollup->evictedBefore = rollup->records[rollup->first].startTime;
+            }
+            rollup->hasOpen = 0;
+        }
+        if (!rollup->hasOpen) {
+            resetAggregate(&rollup->open, bucketStart);
+            rollup->hasOpen = 1;
+        }
+
+        DeformationAggregate *open = &rollup->open;
+        double t = sample.timestamp - bucketStart;
+        open->count++;
+        open->min = fmin(open->min, sample.displacement);
+        open->max = fmax(open->max, sample.displacement);
+        open->sumX += sample.displacement;
+        open->sumT += t;
+        open->sumTT += t * t;
+        open->sumTX += t * sample.displacement;
+    }
+}
+
+// Logical index i counts closed records oldest first; index count is the open bucket.
+const DeformationAggregate *rollupRecord(RollupLevel *rollup, int i) {
+    if (i == rollup->count) {
+        return rollup->hasOpen ? &rollup->open : NULL;
+    }
+    return &rollup->records[(rollup->first + i) % ROLLUP_CAPACITY];
+}
+
+void mergeRollupRange(RollupLevel *rollup, double from, double to, DeformationAggregate *result) {
+    int low = 0;
+    int high = rollup->count + (rollup->hasOpen ? 1 : 0);
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (rollupRecord(rollup, mid)->startTime < from) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    for (int i = low; i <= rollup->count; i++) {
+        const DeformationAggregate *record = rollupRecord(rollup, i);
+        if (record == NULL || record->startTime >= to) {
+            break;
+        }
+        mergeAggregate(result, record);
+    }
+}
+
+// Merges the level's buckets in [from, to) and returns how many seconds of that range
+// the level has already overwritten.
+double mergeRetainedRange(RollupLevel *rollup, double from, double to, DeformationAggregate *result) {
+    mergeRollupRange(rollup, from, to, result);
+    return from < rollup->evictedBefore ? fmin(to, rollup->evictedBefore) - from : 0;
+}
+
+// Covers [from, to) with whole buckets of the coarsest level that fits, and fills the
+// unaligned edges from finer levels, so a long query touches only a handful of records.
+// Returns the seconds of the range that could not be covered because a level needed for
+// an edge has already overwritten it; 0 means the result covers the whole range.
+double queryRollupRange(int level, double from, double to, DeformationAggregate *result) {
+    if (from >= to) {
+        return 0;
+    }
+    if (level == 0) {
+        return mergeRetainedRange(&rollups[0], from, to, result);
+    }
+    double period = rollups[level].period;
+    double alignedFrom = ceil(from / period) * period;
+    double alignedTo = floor(to / period) * period;
+    if (alignedFrom >= alignedTo) {
+        return queryRollupRange(level - 1, from, to, result);
+    }
+    double missing = queryRollupRange(level - 1, from, alignedFrom, result);
+    missing += mergeRetainedRange(&rollups[level], alignedFrom, alignedTo, result);
+    return missing + queryRollupRange(level - 1, alignedTo, to, result);
+}
+
+void reportDeformationTrend(double from, double to) {
+    DeformationAggregate result;
+    resetAggregate(&result, from);
+    double missing = queryRollupRange(ROLLUP_LEVELS - 1, from, to, &result);
+    if (result.count == 0) {
+        printf("No deformation data between %.2f and %.2f\n", from, to);
+        return;
+    }
+    printf("Deformation %.2f-%.2f: min %.2f, max %.2f, mean %.2f, rate %.4f per second (%ld samples)\n",
+           from, to, result.min, result.max, aggregateMean(&result), aggregateSlope(&result), result.count);
+    if (missing > 0) {
+        printf("Warning: %.2f seconds of that range are older than the rollups retain and are not included\n", missing);
+    }
+}
+
 void recordData() {
     if (dataIndex < MAX_SAMPLES) {
         double displacement = getSensorReading();
@@ -30,6 +279,8 @@ void recordData() {
 
         data[dataIndex].timestamp = timestamp;
         data[dataIndex].displacement = displacement;
+        updateTrendEstimator(&trendEstimator, data[dataIndex]);
+        addToRollups(data[dataIndex]);
         dataIndex++;
     } else {
         printf("Data storage full\n");
@@ -113,6 +364,7 @@ void sendAlert(double displacement) {
 int main() {
     printf("Ground deformation monitoring system started.\n");
     calibrateSensor();
+    initializeRollups();
 
     for (int i = 0; i < 50; i++) {
         recordData();
@@ -131,6 +383,8 @@ int main() {
             double filteredDisplacement = filterData();
             printf("Filtered displacement at timestamp %.2f: %.2f\n",
                    data[dataIndex-1].timestamp, filteredDisplacement);
+            printf("Displacement rate over last %d samples: %.4f per second\n",
+                   trendEstimator.count, displacementRate(&trendEstimator));
         }
 
         logDataToFile();
@@ -138,6 +392,8 @@ int main() {
     }
 
     performStatistics();
+    reportDeformationTrend(0, data[dataIndex-1].timestamp + SAMPLING_INTERVAL);
+    reportDeformationTrend(10.5, 42);
     resetData();
 
     return 0;
@@ -1,39 +1,173 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 #define MAX_SAMPLES 1000
 #define SAMPLING_INTERVAL 1 
 #define SEISMIC_THRESHOLD 0.2 
 #define EVENT_DURATION_THRESHOLD 0.05 
 #define NUM_SENSORS 5 
+#define ALIGN_GRID_STEP 1.0
+#define MAX_ALIGN_GAP 2.5
+#define SAMPLE_DROP_PERCENT 5
+#define BLOCK_SAMPLES 64
+#define MAX_BLOCKS ((MAX_SAMPLES + BLOCK_SAMPLES - 1) / BLOCK_SAMPLES)
+#define CACHE_LINE_SIZE 64
+#define RING_CAPACITY 32
+#define MONITOR_TICKS 50
+#define ACQUISITION_PERIOD_NS 1000000L
+#define FUSION_PERIOD_NS 2000000L
+#define SLOW_SENSOR_PERCENT 10
+#define GPS_FIX_TICKS 5
+#define GPS_TIME_JITTER_MS 2
+#define CLOCK_FIT_FIXES 8
+#define CLOCK_HOLDOVER_SECONDS 20.0
 
 typedef struct {
     double timestamp;
     double displacement;
     double acceleration;
     double sensorSpecificData;
+    int timeQuality;
 } SensorData;
 
+typedef enum {
+    TIME_QUALITY_UNLOCKED,
+    TIME_QUALITY_LOCKED,
+    TIME_QUALITY_HOLDOVER
+} TimeQuality;
+
+typedef struct {
+    float latitude;
+    float longitude;
+    float altitude;
+    char time[11];
+    char status;
+} GPS_Data;
+
+typedef struct {
+    double localTime;
+    double gpsTime;
+} ClockFix;
+
+// Per-sensor mapping from the free-running local clock to GPS time. The published
+// fields are read lock-free by the acquisition threads; the fit state below them is
+// only touched by the discipline thread.
+typedef struct {
+    atomic_uint sequence;
+    _Atomic double referenceLocal;
+    _Atomic double referenceGps;
+    _Atomic double rate;
+    _Atomic double lastFixLocal;
+    atomic_int locked;
+    ClockFix fixes[CLOCK_FIT_FIXES];
+    int fixStart;
+    int fixCount;
+    double dayOffset;
+    double lastTimeOfDay;
+} ClockModel;
+
 typedef struct {
     SensorData sensorData[MAX_SAMPLES];
     int dataIndex;
+    int tick;
+    unsigned int rngState;
+    double clockOffset;
+    double clockDrift;
     double calibrationFactor; 
     char sensorName[20];
 } SeismicSensor;
 
+// Time-major, channel-minor block: all sensors for one grid instant sit next to each
+// other, one array per field, so fusion at index i reads contiguous memory.
+typedef struct {
+    double timestamp[BLOCK_SAMPLES];
+    double displacement[BLOCK_SAMPLES][NUM_SENSORS];
+    double acceleration[BLOCK_SAMPLES][NUM_SENSORS];
+    double valid[BLOCK_SAMPLES][NUM_SENSORS];
+    int count;
+} ChannelSampleBlock;
+
+typedef enum {
+    FUSE_WEIGHTED_AVERAGE,
+    FUSE_MEDIAN,
+    FUSE_MAX
+} FusionMode;
+
+typedef struct {
+    SensorData sample;
+    long long enqueuedNs;
+} RingSlot;
+
+// Single-producer/single-consumer ring between one acquisition thread and the fusion
+// thread. Producer and consumer indices live on separate cache lines, and each side
+// keeps a cached copy of the other's index so the shared line is only read when the
+// ring looks full or empty.
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t tail;
+    size_t cachedHead;
+    atomic_size_t overflows;
+    _Alignas(CACHE_LINE_SIZE) atomic_size_t head;
+    size_t cachedTail;
+    long long drained;
+    long long latencyTotalNs;
+    long long latencyMaxNs;
+    _Alignas(CACHE_LINE_SIZE) RingSlot slots[RING_CAPACITY];
+} SensorRing;
+
+typedef struct {
+    double timestamp;
+    int sensor;
+} StreamHeapEntry;
+
+// k-way merge state: one heap entry per sensor holding its next unconsumed sample,
+// plus the last consumed sample per sensor to interpolate from.
+typedef struct {
+    StreamHeapEntry heap[NUM_SENSORS];
+    int heapSize;
+    int inHeap[NUM_SENSORS];
+    int cursor[NUM_SENSORS];
+    int hasLast[NUM_SENSORS];
+    SensorData last[NUM_SENSORS];
+    double nextGridTime;
+} StreamAligner;
+
 SeismicSensor sensors[NUM_SENSORS];
+SensorRing sensorRings[NUM_SENSORS];
+ClockModel clockModels[NUM_SENSORS];
+atomic_int activeProducers;
+ChannelSampleBlock fusionBlocks[MAX_BLOCKS];
+double channelWeight[NUM_SENSORS];
+int alignedCount = 0;
+StreamAligner streamAligner;
+FusionMode fusionMode = FUSE_WEIGHTED_AVERAGE;
 int eventStartIdx = -1;
 int eventEndIdx = -1;
 int eventInProgress = 0;
 int totalSeismicEvents = 0;
 
-double generateSensorReading() {
-    return (rand() % 100) / 100.0;
+// rand() is not thread-safe, so each acquisition thread draws from its own LCG.
+double generateSensorReading(SeismicSensor *sensor) {
+    sensor->rngState = sensor->rngState * 1103515245u + 12345u;
+    return ((sensor->rngState >> 16) % 100) / 100.0;
+}
+
+long long monotonicNanoseconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
 }
 
 void initializeSensor(SeismicSensor *sensor, const char *sensorName, double calibrationFactor) {
     sensor->dataIndex = 0;
+    sensor->tick = 0;
+    sensor->rngState = (unsigned int)rand();
+    sensor->clockOffset = (rand() % 50) / 100.0;
+    sensor->clockDrift = ((rand() % 21) - 10) / 1000.0;
     sensor->calibrationFactor = calibrationFactor;
     snprintf(sensor->sensorName, sizeof(sensor->sensorName), "%s", sensorName);
     printf("Initializing sensor: %s with calibration factor: %.2f\n", sensor->sensorName, calibrationFactor);
@@ -47,6 +181,10 @@ void logSensorData(SeismicSensor *sensor, double timestamp) {
             sensor->sensorData[sensor->dataIndex].sensorSpecificData);
 }
 
+double alignedTimestamp(int idx) {
+    return fusionBlocks[idx / BLOCK_SAMPLES].timestamp[idx % BLOCK_SAMPLES];
+}
+
 int isSeismicEventTriggered(double displacement) {
     return displacement > SEISMIC_THRESHOLD;
 }
@@ -55,7 +193,7 @@ void startEvent(int idx) {
     if (!eventInProgress) {
         eventStartIdx = idx;
         eventInProgress = 1;
-        printf("Seismic event started at timestamp %.2f\n", sensors[0].sensorData[idx].timestamp);
+        printf("Seismic event started at timestamp %.2f\n", alignedTimestamp(idx));
     }
 }
 
@@ -63,39 +201,539 @@ void endEvent(int idx) {
     if (eventInProgress) {
         eventEndIdx = idx;
         eventInProgress = 0;
-        double duration = sensors[0].sensorData[eventEndIdx].timestamp - sensors[0].sensorData[eventStartIdx].timestamp;
-        printf("Seismic event ended at timestamp %.2f\n", sensors[0].sensorData[idx].timestamp);
+        double duration = alignedTimestamp(eventEndIdx) - alignedTimestamp(eventStartIdx);
+        printf("Seismic event ended at timestamp %.2f\n", alignedTimestamp(idx));
         printf("Event duration: %.2f seconds\n", duration);
         totalSeismicEvents++;
     }
 }
 
-void recordSensorData(SeismicSensor *sensor) {
+void recordSensorData(SeismicSensor *sensor, const SensorData *sample) {
     if (sensor->dataIndex < MAX_SAMPLES) {
-        double displacement = generateSensorReading() * sensor->calibrationFactor;
-        double acceleration = generateSensorReading();
-        double sensorSpecificData = generateSensorReading();
-        double timestamp = sensor->dataIndex * SAMPLING_INTERVAL;
-
-        sensor->sensorData[sensor->dataIndex].timestamp = timestamp;
-        sensor->sensorData[sensor->dataIndex].displacement = displacement;
-        sensor->sensorData[sensor->dataIndex].acceleration = acceleration;
-        sensor->sensorData[sensor->dataIndex].sensorSpecificData = sensorSpecificData;
-
-        logSensorData(sensor, timestamp);
+        sensor->sensorData[sensor->dataIndex] = *sample;
+        logSensorData(sensor, sample->timestamp);
         sensor->dataIndex++;
     } else {
         printf("Sensor %s data storage full.\n", sensor->sensorName);
     }
 }
 
-void evaluateSeismicEventDuration() {
-    for (int i = 0; i < sensors[0].dataIndex; i++) {
-        double displacement = 0;
+// "hhmmss.sss" to seconds since midnight.
+double parseGPSTimeOfDay(const char *time) {
+    if (strlen(time) < 6) {
+        return -1;
+    }
+    int hours = (time[0] - '0') * 10 + (time[1] - '0');
+    int minutes = (time[2] - '0') * 10 + (time[3] - '0');
+    return hours * 3600.0 + minutes * 60.0 + atof(time + 4);
+}
+
+void initializeClockModel(ClockModel *model) {
+    atomic_init(&model->sequence, 0);
+    atomic_init(&model->referenceLocal, 0.0);
+    atomic_init(&model->referenceGps, 0.0);
+    atomic_init(&model->rate, 1.0);
+    atomic_init(&model->lastFixLocal, 0.0);
+    atomic_init(&model->locked, 0);
+    model->fixStart = 0;
+    model->fixCount = 0;
+    model->dayOffset = 0;
+    model->lastTimeOfDay = -1;
+}
+
+// Least-squares fit of GPS time against local time over the last CLOCK_FIT_FIXES fixes,
+// centred on the mean so large absolute times do not cost precision. The result is
+// published under a sequence lock: the writer makes the counter odd while it updates.
+void feedClockModel(ClockModel *model, double localTime, const GPS_Data *gps) {
+    double timeOfDay = parseGPSTimeOfDay(gps->time);
+    if (gps->status != 'A' || timeOfDay < 0) {
+        return;
+    }
+    if (model->lastTimeOfDay >= 0 && timeOfDay < model->lastTimeOfDay - 43200.0) {
+        model->dayOffset += 86400.0;
+    }
+    model->lastTimeOfDay = timeOfDay;
+
+    int slot = (model->fixStart + model->fixCount) % CLOCK_FIT_FIXES;
+    model->fixes[slot].localTime = localTime;
+    model->fixes[slot].gpsTime = timeOfDay + model->dayOffset;
+    if (model->fixCount < CLOCK_FIT_FIXES) {
+        model->fixCount++;
+    } else {
+        model->fixStart = (model->fixStart + 1) % CLOCK_FIT_FIXES;
+    }
+    if (model->fixCount < 2) {
+        return;
+    }
+
+    double meanLocal = 0, meanGps = 0;
+    for (int i = 0; i < model->fixCount; i++) {
+        ClockFix *fix = &model->fixes[(model->fixStart + i) % CLOCK_FIT_FIXES];
+        meanLocal += fix->localTime;
+        meanGps += fix->gpsTime;
+    }
+    meanLocal /= model->fixCount;
+    meanGps /= model->fixCount;
+
+    double covariance = 0, variance = 0;
+    for (int i = 0; i < model->fixCount; i++) {
+        ClockFix *fix = &model->fixes[(model->fixStart + i) % CLOCK_FIT_FIXES];
+        covariance += (fix->localTime - meanLocal) * (fix->gpsTime - meanGps);
+        variance += (fix->localTime - meanLocal) * (fix->localTime - meanLocal);
+    }
+    if (variance <= 0) {
+        return;
+    }
+
+    unsigned int sequence = atomic_load_explicit(&model->sequence, memory_order_relaxed);
+    atomic_store_explicit(&model->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&model->referenceLocal, meanLocal, memory_order_relaxed);
+    atomic_store_explicit(&model->referenceGps, meanGps, memory_order_relaxed);
+    atomic_store_explicit(&model->rate, covariance / variance, memory_order_relaxed);
+    atomic_store_explicit(&model->lastFixLocal, localTime, memory_order_relaxed);
+    atomic_store_explicit(&model->locked, 1, memory_order_relaxed);
+    atomic_store_explicit(&model->sequence, sequence + 2, memory_order_release);
+}
+
+// Lock-free read for the acquisition threads: a handful of loads and one multiply-add.
+// Until the first fit the local time is passed through unchanged.
+double stampSampleTime(ClockModel *model, double localTime, int *quality) {
+    double referenceLocal, referenceGps, rate, lastFixLocal;
+    int locked;
+    unsigned int before, after;
+
+    do {
+        before = atomic_load_explicit(&model->sequence, memory_order_acquire);
+        referenceLocal = atomic_load_explicit(&model->referenceLocal, memory_order_relaxed);
+        referenceGps = atomic_load_explicit(&model->referenceGps, memory_order_relaxed);
+        rate = atomic_load_explicit(&model->rate, memory_order_relaxed);
+        lastFixLocal = atomic_load_explicit(&model->lastFixLocal, memory_order_relaxed);
+        locked = atomic_load_explicit(&model->locked, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&model->sequence, memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    if (!locked) {
+        *quality = TIME_QUALITY_UNLOCKED;
+        return localTime;
+    }
+    *quality = (localTime - lastFixLocal > CLOCK_HOLDOVER_SECONDS) ? TIME_QUALITY_HOLDOVER : TIME_QUALITY_LOCKED;
+    return referenceGps + (localTime - referenceLocal) * rate;
+}
+
+// Samples taken before the first fit carry raw local time. Once the model locks they are
+// mapped onto GPS time like any later sample, so a station's timestamps never jump at
+// the lock. Returns 0 while the model is still unlocked.
+int restampSampleTime(ClockModel *model, SensorData *sample) {
+    int quality;
+    double timestamp = stampSampleTime(model, sample->timestamp, &quality);
+    if (quality == TIME_QUALITY_UNLOCKED) {
+        return 0;
+    }
+    sample->timestamp = timestamp;
+    sample->timeQuality = quality;
+    return 1;
+}
+
+// Simulated receiver at each sensor site: every GPS_FIX_TICKS it reports GPS time with a
+// few milliseconds of jitter, paired with the sensor's free-running clock at that instant.
+void *gpsDisciplineThread(void *arg) {
+    struct timespec period = {0, ACQUISITION_PERIOD_NS};
+    unsigned int jitterState = 2024u;
+    (void)arg;
+
+    for (int tick = 0; tick < MONITOR_TICKS; tick += GPS_FIX_TICKS) {
+        double trueTime = tick * SAMPLING_INTERVAL;
+        for (int j = 0; j < NUM_SENSORS; j++) {
+            GPS_Data gps;
+            jitterState = jitterState * 1103515245u + 12345u;
+            int jitterMs = (int)((jitterState >> 16) % (2 * GPS_TIME_JITTER_MS + 1)) - GPS_TIME_JITTER_MS;
+            double reported = trueTime + jitterMs / 1000.0;
+            if (reported < 0) {
+                reported = 0;
+            }
+            int hours = (int)(reported / 3600.0);
+            int minutes = (int)((reported - hours * 3600.0) / 60.0);
+            double seconds = reported - hours * 3600.0 - minutes * 60.0;
+            char formatted[32];
+            snprintf(formatted, sizeof(formatted), "%02d%02d%06.3f", hours % 24, minutes, seconds);
+            memcpy(gps.time, formatted, sizeof(gps.time) - 1);
+            gps.time[sizeof(gps.time) - 1] = '\0';
+            gps.status = 'A';
+            gps.latitude = 0;
+            gps.longitude = 0;
+            gps.altitude = 0;
+
+            double localTime = trueTime * (1.0 + sensors[j].clockDrift) + sensors[j].clockOffset;
+            feedClockModel(&clockModels[j], localTime, &gps);
+        }
+        for (int k = 0; k < GPS_FIX_TICKS; k++) {
+            nanosleep(&period, NULL);
+        }
+    }
+    return NULL;
+}
+
+void printClockModels() {
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        int quality;
+        double zero = stampSampleTime(&clockModels[j], sensors[j].clockOffset, &quality);
+        double rate = atomic_load(&clockModels[j].rate);
+        printf("Sensor %s clock: true drift %+.4f, fitted %+.4f, residual offset %+.4f s, %s\n",
+               sensors[j].sensorName, sensors[j].clockDrift, 1.0 / rate - 1.0, zero,
+               quality == TIME_QUALITY_LOCKED ? "locked" : quality == TIME_QUALITY_HOLDOVER ? "holdover" : "unlocked");
+    }
+
+    int quality;
+    long long start = monotonicNanoseconds();
+    double sink = 0;
+    for (int i = 0; i < 1000000; i++) {
+        sink += stampSampleTime(&clockModels[i % NUM_SENSORS], i, &quality);
+    }
+    printf("Timestamping cost: %.1f ns per sample (checksum %.0f)\n",
+           (monotonicNanoseconds() - start) / 1e6, sink);
+}
+
+int acquireSensorSample(SeismicSensor *sensor, ClockModel *clock, SensorData *sample) {
+    double localTime = sensor->tick * SAMPLING_INTERVAL * (1.0 + sensor->clockDrift) + sensor->clockOffset;
+    sample->timestamp = stampSampleTime(clock, localTime, &sample->timeQuality);
+    sensor->tick++;
+    if (generateSensorReading(sensor) * 100 < SAMPLE_DROP_PERCENT) {
+        return 0;
+    }
+    sample->displacement = generateSensorReading(sensor) * sensor->calibrationFactor;
+    sample->acceleration = generateSensorReading(sensor);
+    sample->sensorSpecificData = generateSensorReading(sensor);
+    return 1;
+}
+
+void initializeSensorRing(SensorRing *ring) {
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->overflows, 0);
+    ring->cachedHead = 0;
+    ring->cachedTail = 0;
+    ring->drained = 0;
+    ring->latencyTotalNs = 0;
+    ring->latencyMaxNs = 0;
+}
+
+int pushSensorRing(SensorRing *ring, const SensorData *sample) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if (tail - ring->cachedHead == RING_CAPACITY) {
+        ring->cachedHead = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tail - ring->cachedHead == RING_CAPACITY) {
+            atomic_fetch_add_explicit(&ring->overflows, 1, memory_order_relaxed);
+            return 0;
+        }
+    }
+    RingSlot *slot = &ring->slots[tail % RING_CAPACITY];
+    slot->sample = *sample;
+    slot->enqueuedNs = monotonicNanoseconds();
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+// Consumer-side view of the oldest sample without taking it; the slot stays the
+// consumer's until popSensorRing advances head.
+SensorData *peekSensorRing(SensorRing *ring) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head == ring->cachedTail) {
+        ring->cachedTail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head == ring->cachedTail) {
+            return NULL;
+        }
+    }
+    return &ring->slots[head % RING_CAPACITY].sample;
+}
+
+int popSensorRing(SensorRing *ring, SensorData *sample) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (head == ring->cachedTail) {
+        ring->cachedTail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head == ring->cachedTail) {
+            return 0;
+        }
+    }
+    RingSlot *slot = &ring->slots[head % RING_CAPACITY];
+    long long latency = monotonicNanoseconds() - slot->enqueuedNs;
+    *sample = slot->sample;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    ring->drained++;
+    ring->latencyTotalNs += latency;
+    if (latency > ring->latencyMaxNs) {
+        ring->latencyMaxNs = latency;
+    }
+    return 1;
+}
+
+void *sensorAcquisitionThread(void *arg) {
+    int j = (int)(long)arg;
+    SeismicSensor *sensor = &sensors[j];
+    struct timespec period = {0, ACQUISITION_PERIOD_NS};
+
+    for (int i = 0; i < MONITOR_TICKS; i++) {
+        SensorData sample;
+        if (acquireSensorSample(sensor, &clockModels[j], &sample)) {
+            pushSensorRing(&sensorRings[j], &sample);
+        }
+        nanosleep(&period, NULL);
+        if (generateSensorReading(sensor) * 100 < SLOW_SENSOR_PERCENT) {
+            nanosleep(&period, NULL);
+        }
+    }
+    atomic_fetch_sub_explicit(&activeProducers, 1, memory_order_release);
+    return NULL;
+}
+
+// Moves everything the acquisition threads have produced into the per-sensor buffers.
+// The stream aligner then consumes those buffers in timestamp order. Samples stamped
+// before their clock model locked are restamped onto GPS time; while holdUnlocked is set
+// and the model has not locked yet they stay in the ring, so one sensor's buffer never
+// mixes the two timebases.
+int drainSensorRings(int holdUnlocked) {
+    int drained = 0;
+    SensorData sample;
+    SensorData *pending;
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        while ((pending = peekSensorRing(&sensorRings[j])) != NULL) {
+            if (pending->timeQuality == TIME_QUALITY_UNLOCKED && !restampSampleTime(&clockModels[j], pending) &&
+                holdUnlocked) {
+                break;
+            }
+            popSensorRing(&sensorRings[j], &sample);
+            recordSensorData(&sensors[j], &sample);
+            drained++;
+        }
+    }
+    return drained;
+}
+
+void printSensorRingStatistics() {
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        SensorRing *ring = &sensorRings[j];
+        double averageUs = ring->drained > 0 ? ring->latencyTotalNs / (double)ring->drained / 1000.0 : 0;
+        printf("Sensor %s ring: drained %lld, overflows %zu, latency avg %.1f us, max %.1f us\n",
+               sensors[j].sensorName, ring->drained, atomic_load(&ring->overflows),
+               averageUs, ring->latencyMaxNs / 1000.0);
+    }
+}
+
+void initializeStreamAligner(StreamAligner *aligner) {
+    aligner->heapSize = 0;
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        aligner->inHeap[j] = 0;
+        aligner->cursor[j] = 0;
+        aligner->hasLast[j] = 0;
+    }
+    aligner->nextGridTime = 0;
+}
+
+void pushStreamHeap(StreamAligner *aligner, double timestamp, int sensor) {
+    int i = aligner->heapSize++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (aligner->heap[parent].timestamp <= timestamp) {
+            break;
+        }
+        aligner->heap[i] = aligner->heap[parent];
+        i = parent;
+    }
+    aligner->heap[i].timestamp = timestamp;
+    aligner->heap[i].sensor = sensor;
+    aligner->inHeap[sensor] = 1;
+}
+
+StreamHeapEntry popStreamHeap(StreamAligner *aligner) {
+    StreamHeapEntry top = aligner->heap[0];
+    StreamHeapEntry last = aligner->heap[--aligner->heapSize];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= aligner->heapSize) {
+            break;
+        }
+        if (child + 1 < aligner->heapSize && aligner->heap[child + 1].timestamp < aligner->heap[child].timestamp) {
+            child++;
+        }
+        if (last.timestamp <= aligner->heap[child].timestamp) {
+            break;
+        }
+        aligner->heap[i] = aligner->heap[child];
+        i = child;
+    }
+    if (aligner->heapSize > 0) {
+        aligner->heap[i] = last;
+    }
+    aligner->inHeap[top.sensor] = 0;
+    return top;
+}
+
+// Advances the sensor's cursor past samples that never got GPS time, which only happens
+// when its clock model did not lock at all. Those are logged but kept out of alignment.
+// Returns whether a sample on GPS time is waiting.
+int nextAlignableSample(StreamAligner *aligner, int j) {
+    while (aligner->cursor[j] < sensors[j].dataIndex &&
+           sensors[j].sensorData[aligner->cursor[j]].timeQuality == TIME_QUALITY_UNLOCKED) {
+        aligner->cursor[j]++;
+    }
+    return aligner->cursor[j] < sensors[j].dataIndex;
+}
+
+// Samples from the sensor's own buffer that have not entered the merge yet.
+void refillStreamHeap(StreamAligner *aligner) {
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        if (!aligner->inHeap[j] && nextAlignableSample(aligner, j)) {
+            pushStreamHeap(aligner, sensors[j].sensorData[aligner->cursor[j]].timestamp, j);
+        }
+    }
+}
+
+// A grid point can be emitted once every sensor either has a pending sample at or after
+// it, or has been silent for longer than MAX_ALIGN_GAP and is treated as a dropout.
+int isGridPointReady(StreamAligner *aligner, double gridTime) {
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        if (aligner->inHeap[j]) {
+            continue;
+        }
+        double lastTime = aligner->hasLast[j] ? aligner->last[j].timestamp : 0;
+        if (gridTime < lastTime + MAX_ALIGN_GAP) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void emitAlignedSample(StreamAligner *aligner, double gridTime) {
+    ChannelSampleBlock *block = &fusionBlocks[alignedCount / BLOCK_SAMPLES];
+    int row = alignedCount % BLOCK_SAMPLES;
+    block->timestamp[row] = gridTime;
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        block->valid[row][j] = 0;
+        block->displacement[row][j] = 0;
+        block->acceleration[row][j] = 0;
+        if (!aligner->hasLast[j] || !aligner->inHeap[j]) {
+            continue;
+        }
+        SensorData *before = &aligner->last[j];
+        SensorData *after = &sensors[j].sensorData[aligner->cursor[j]];
+        double gap = after->timestamp - before->timestamp;
+        if (gap > MAX_ALIGN_GAP) {
+            continue;
+        }
+        double weight = gap > 0 ? (gridTime - before->timestamp) / gap : 0;
+        block->displacement[row][j] = before->displacement + weight * (after->displacement - before->displacement);
+        block->acceleration[row][j] = before->acceleration + weight * (after->acceleration - before->acceleration);
+        block->valid[row][j] = 1;
+    }
+    block->count = row + 1;
+    alignedCount++;
+}
+
+// Merges the per-sensor streams in timestamp order and resamples them onto a common
+// ALIGN_GRID_STEP grid. Only one pending and one previous sample per sensor are held.
+void alignSensorStreams(StreamAligner *aligner) {
+    while (alignedCount < MAX_SAMPLES) {
+        double gridTime = aligner->nextGridTime;
+        refillStreamHeap(aligner);
+
+        while (aligner->heapSize > 0 && aligner->heap[0].timestamp < gridTime) {
+            StreamHeapEntry entry = popStreamHeap(aligner);
+            int j = entry.sensor;
+            aligner->last[j] = sensors[j].sensorData[aligner->cursor[j]];
+            aligner->hasLast[j] = 1;
+            aligner->cursor[j]++;
+            if (nextAlignableSample(aligner, j)) {
+                pushStreamHeap(aligner, sensors[j].sensorData[aligner->cursor[j]].timestamp, j);
+            }
+        }
+
+        if (!isGridPointReady(aligner, gridTime)) {
+            break;
+        }
+        emitAlignedSample(aligner, gridTime);
+        aligner->nextGridTime += ALIGN_GRID_STEP;
+    }
+}
+
+// Fusion kernels: each writes one fused displacement per block row, NAN when no sensor
+// was valid. The inner loops run over the contiguous channel dimension with masks
+// instead of branches so they vectorize.
+void fuseBlockWeightedAverage(const ChannelSampleBlock *block, double *fused) {
+    for (int r = 0; r < block->count; r++) {
+        double sum = 0;
+        double weightSum = 0;
+        for (int j = 0; j < NUM_SENSORS; j++) {
+            double w = channelWeight[j] * block->valid[r][j];
+            sum += w * block->displacement[r][j];
+            weightSum += w;
+        }
+        fused[r] = weightSum > 0 ? sum / weightSum : NAN;
+    }
+}
+
+void fuseBlockMax(const ChannelSampleBlock *block, double *fused) {
+    for (int r = 0; r < block->count; r++) {
+        double best = -INFINITY;
         for (int j = 0; j < NUM_SENSORS; j++) {
-            displacement += sensors[j].sensorData[i].displacement;
+            double value = block->valid[r][j] > 0 ? block->displacement[r][j] : -INFINITY;
+            best = fmax(best, value);
+        }
+        fused[r] = isinf(best) ? NAN : best;
+    }
+}
+
+void fuseBlockMedian(const ChannelSampleBlock *block, double *fused) {
+    for (int r = 0; r < block->count; r++) {
+        double values[NUM_SENSORS];
+        int n = 0;
+        for (int j = 0; j < NUM_SENSORS; j++) {
+            if (block->valid[r][j] > 0) {
+                double value = block->displacement[r][j];
+                int k = n++;
+                while (k > 0 && values[k - 1] > value) {
+                    values[k] = values[k - 1];
+                    k--;
+                }
+                values[k] = value;
+            }
+        }
+        if (n == 0) {
+            fused[r] = NAN;
+        } else {
+            fused[r] = (n % 2) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+        }
+    }
+}
+
+void fuseBlock(const ChannelSampleBlock *block, FusionMode mode, double *fused) {
+    switch (mode) {
+        case FUSE_MEDIAN:
+            fuseBlockMedian(block, fused);
+            break;
+        case FUSE_MAX:
+            fuseBlockMax(block, fused);
+            break;
+        default:
+            fuseBlockWeightedAverage(block, fused);
+            break;
+    }
+}
+
+void evaluateSeismicEventDuration() {
+    double fused[BLOCK_SAMPLES];
+    alignSensorStreams(&streamAligner);
+
+    for (int i = 0; i < alignedCount; i++) {
+        if (i % BLOCK_SAMPLES == 0) {
+            fuseBlock(&fusionBlocks[i / BLOCK_SAMPLES], fusionMode, fused);
+        }
+        double displacement = fused[i % BLOCK_SAMPLES];
+        if (isnan(displacement)) {
+            continue;
         }
-        displacement /= NUM_SENSORS;
 
         if (isSeismicEventTriggered(displacement)) {
             if (!eventInProgress) {
@@ -135,10 +773,32 @@ void processSeismicData() {
 void monitorSeismicActivity() {
     printf("Starting seismic activity monitoring...\n");
 
-    for (int i = 0; i < 50; i++) {
-        for (int j = 0; j < NUM_SENSORS; j++) {
-            recordSensorData(&sensors[j]);
+    pthread_t producers[NUM_SENSORS];
+    pthread_t gpsReceiver;
+    struct timespec period = {0, FUSION_PERIOD_NS};
+    int started[NUM_SENSORS];
+    int gpsStarted;
+
+    atomic_init(&activeProducers, NUM_SENSORS);
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        initializeSensorRing(&sensorRings[j]);
+        initializeClockModel(&clockModels[j]);
+    }
+    gpsStarted = pthread_create(&gpsReceiver, NULL, gpsDisciplineThread, NULL) == 0;
+    if (!gpsStarted) {
+        printf("Error starting GPS discipline thread; samples stay on local clocks and out of alignment.\n");
+    }
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        started[j] = pthread_create(&producers[j], NULL, sensorAcquisitionThread, (void *)(long)j) == 0;
+        if (!started[j]) {
+            printf("Error starting acquisition thread for %s.\n", sensors[j].sensorName);
+            atomic_fetch_sub(&activeProducers, 1);
         }
+    }
+
+    for (int i = 0; ; i++) {
+        int producing = atomic_load_explicit(&activeProducers, memory_order_acquire) > 0;
+        drainSensorRings(gpsStarted);
 
         if (i % 10 == 0) {
             processSeismicData();
@@ -147,8 +807,25 @@ void monitorSeismicActivity() {
         if (i % 5 == 0) {
             saveSeismicDataToFile();
         }
+
+        if (!producing) {
+            break;
+        }
+        nanosleep(&period, NULL);
     }
 
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        if (started[j]) {
+            pthread_join(producers[j], NULL);
+        }
+    }
+    if (gpsStarted) {
+        pthread_join(gpsReceiver, NULL);
+    }
+    drainSensorRings(0);
+    processSeismicData();
+    printSensorRingStatistics();
+    printClockModels();
     printf("Seismic monitoring completed.\n");
 }
 
@@ -159,6 +836,10 @@ int main() {
     initializeSensor(&sensors[2], "Sensor 3", 0.8);
     initializeSensor(&sensors[3], "Sensor 4", 1.1);
     initializeSensor(&sensors[4], "Sensor 5", 1.0);
+    for (int j = 0; j < NUM_SENSORS; j++) {
+        channelWeight[j] = sensors[j].calibrationFactor;
+    }
+    initializeStreamAligner(&streamAligner);
 
     monitorSeismicActivity();
 
@@ -1,15 +1,42 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef _WIN32
+#include <io.h>
+#define fsync _commit
+#define ftruncate _chsize
+#else
+#include <unistd.h>
+#endif
 
 #define MAX_SAMPLES 1000
 #define SAMPLING_INTERVAL 1 
 #define FILTER_WINDOW 5
 #define SEISMIC_THRESHOLD 0.10 
 #define PREDICTION_THRESHOLD 0.20 
-#define ALERT_THRESHOLD 0.25 
 #define DYNAMIC_THRESHOLD_ADJUSTMENT 0.02
 #define MULTI_SENSOR_COUNT 3 
+#define WAL_FILE "seismic_activity_log.wal"
+#define WAL_MAGIC_PREFIX 0x53574C00u
+#define WAL_MAGIC_PREFIX_MASK 0xFFFFFF00u
+#define WAL_FORMAT_VERSION 3
+#define WAL_RECORD_MAGIC (WAL_MAGIC_PREFIX | ('0' + WAL_FORMAT_VERSION))
+#define WAL_SYNC_BATCH 16
+#define EVENT_WAL_FILE "seismic_events.wal"
+#define EVENT_TRIGGER_THRESHOLD 0.90
+#define PRE_TRIGGER_SAMPLES 5
+#define POST_TRIGGER_SAMPLES 8
+#define MAX_EVENT_SAMPLES 256
+#define CONTINUOUS_RECORD_SAMPLES 16
+#define WAVEFORM_CHANNELS (MULTI_SENSOR_COUNT + 3)
+#define COUNTS_PER_UNIT 10000.0
+#define COUNTS_PER_SECOND 1000.0
+#define MAX_COUNTS 1073741823.0
+#define COMPRESSION_GROUP 16
+#define MAX_COMPRESSED_BYTES (sizeof(CompressedWaveformHeader) + \
+    WAVEFORM_CHANNELS * ((MAX_EVENT_SAMPLES + COMPRESSION_GROUP - 1) / COMPRESSION_GROUP) * (1 + COMPRESSION_GROUP * 4))
 
 typedef struct {
     double timestamp;
@@ -18,9 +45,68 @@ typedef struct {
     double sensorData[MULTI_SENSOR_COUNT]; 
 } SeismicActivitySample;
 
+// On-disk record: header followed by a compressed waveform payload of payloadBytes
+// holding sampleCount samples. The CRC covers the sequence number, the count and the
+// payload, so a torn or partially flushed tail is detected on recovery. The magic is
+// "SWL" plus the layout version; bump WAL_FORMAT_VERSION whenever the layout changes.
+typedef struct {
+    uint32_t magic;
+    uint32_t crc;
+    uint64_t sequence;
+    uint32_t sampleCount;
+    uint32_t payloadBytes;
+} WalRecordHeader;
+
+// Steim-like waveform block: every field is quantized to integer counts and stored as
+// first differences. first[] is the integration constant and last[] lets the decoder
+// verify that the reconstructed trace ends where the encoder's did. Channel 0 is time
+// relative to baseTimestamp, then displacement, acceleration and the sensor channels.
+typedef struct {
+    double baseTimestamp;
+    int32_t first[WAVEFORM_CHANNELS];
+    int32_t last[WAVEFORM_CHANNELS];
+} CompressedWaveformHeader;
+
+typedef struct {
+    FILE *file;
+    uint64_t nextSequence;
+    int pendingSync;
+} WriteAheadLog;
+
+typedef enum {
+    RECORD_CONTINUOUS,
+    RECORD_EVENTS
+} RecordingMode;
+
+// Strong-motion style recorder: the last PRE_TRIGGER_SAMPLES are kept in a ring, and a
+// trigger opens an event that runs until POST_TRIGGER_SAMPLES pass without a retrigger.
+typedef struct {
+    SeismicActivitySample preTrigger[PRE_TRIGGER_SAMPLES];
+    int preTriggerStart;
+    int preTriggerCount;
+    SeismicActivitySample eventSamples[MAX_EVENT_SAMPLES];
+    int eventSampleCount;
+    int postTriggerRemaining;
+    int recording;
+    long samplesSeen;
+    long samplesPersisted;
+    long eventsPersisted;
+} EventRecorder;
+
 SeismicActivitySample data[MAX_SAMPLES];
 int dataIndex = 0;
+int loggedIndex = 0;
+int walBatchStart = 0;
 double ALERT_THRESHOLD = SEISMIC_THRESHOLD;
+WriteAheadLog wal;
+WriteAheadLog eventWal;
+EventRecorder eventRecorder;
+RecordingMode recordingMode = RECORD_EVENTS;  // --mode continuous restores the full log
+uint32_t crcTable[256];
+int32_t waveformCounts[WAVEFORM_CHANNELS][MAX_EVENT_SAMPLES];
+unsigned char compressedBuffer[MAX_COMPRESSED_BYTES];
+long rawBytesWritten = 0;
+long compressedBytesWritten = 0;
 
 double getSeismicSensorReading() {
     return (rand() % 100) / 100.0; 
@@ -96,16 +182,358 @@ double filterData() {
     return (count > 0) ? filteredValue / count : 0;
 }
 
-void logDataToFile() {
-    FILE *file = fopen("seismic_activity_log.txt", "a");
-    if (file != NULL) {
-        for (int i = 0; i < dataIndex; i++) {
-            fprintf(file, "Timestamp: %.2f, Displacement: %.2f, Acceleration: %.2f\n",
-                    data[i].timestamp, data[i].displacement, data[i].acceleration);
+void initializeCrcTable() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
         }
+        crcTable[i] = c;
+    }
+}
+
+uint32_t updateCrc(uint32_t crc, const void *buffer, size_t length) {
+    const unsigned char *bytes = (const unsigned char *)buffer;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = crcTable[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+int32_t quantizeCounts(double value, double countsPerUnit) {
+    double counts = round(value * countsPerUnit);
+    return (int32_t)fmax(-MAX_COUNTS, fmin(MAX_COUNTS, counts));
+}
+
+// Channel-major so the per-channel difference and zigzag loops run over contiguous ints.
+void quantizeSamples(const SeismicActivitySample *samples, int count, double baseTimestamp) {
+    for (int i = 0; i < count; i++) {
+        waveformCounts[0][i] = quantizeCounts(samples[i].timestamp - baseTimestamp, COUNTS_PER_SECOND);
+        waveformCounts[1][i] = quantizeCounts(samples[i].displacement, COUNTS_PER_UNIT);
+        waveformCounts[2][i] = quantizeCounts(samples[i].acceleration, COUNTS_PER_UNIT);
+        for (int c = 0; c < MULTI_SENSOR_COUNT; c++) {
+            waveformCounts[3 + c][i] = quantizeCounts(samples[i].sensorData[c], COUNTS_PER_UNIT);
+        }
+    }
+}
+
+// Each group of COMPRESSION_GROUP differences is zigzag-encoded and packed at the
+// smallest bit width that fits the whole group, prefixed by a one-byte width.
+size_t encodeChannel(const int32_t *counts, int count, unsigned char *out) {
+    size_t pos = 0;
+    for (int start = 0; start < count; start += COMPRESSION_GROUP) {
+        int n = count - start < COMPRESSION_GROUP ? count - start : COMPRESSION_GROUP;
+        uint32_t zigzag[COMPRESSION_GROUP];
+        uint32_t bits = 0;
+        for (int k = 0; k < n; k++) {
+            int i = start + k;
+            int32_t diff = i > 0 ? counts[i] - counts[i - 1] : 0;
+            zigzag[k] = ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31);
+            bits |= zigzag[k];
+        }
+
+        int width = 0;
+        while (width < 32 && (bits >> width) != 0) {
+            width++;
+        }
+        out[pos++] = (unsigned char)width;
+
+        uint64_t accumulator = 0;
+        int pending = 0;
+        for (int k = 0; k < n; k++) {
+            accumulator |= (uint64_t)zigzag[k] << pending;
+            pending += width;
+            while (pending >= 8) {
+                out[pos++] = (unsigned char)accumulator;
+                accumulator >>= 8;
+                pending -= 8;
+            }
+        }
+        if (pending > 0) {
+            out[pos++] = (unsigned char)accumulator;
+        }
+    }
+    return pos;
+}
+
+size_t decodeChannel(const unsigned char *in, size_t available, int count, int32_t first, int32_t *counts) {
+    size_t pos = 0;
+    int32_t value = first;
+    for (int start = 0; start < count; start += COMPRESSION_GROUP) {
+        int n = count - start < COMPRESSION_GROUP ? count - start : COMPRESSION_GROUP;
+        if (pos >= available || in[pos] > 32) {
+            return 0;
+        }
+        int width = in[pos++];
+        size_t groupBytes = ((size_t)n * width + 7) / 8;
+        if (pos + groupBytes > available) {
+            return 0;
+        }
+
+        uint64_t accumulator = 0;
+        int pending = 0;
+        uint32_t mask = width == 32 ? 0xFFFFFFFFu : (1u << width) - 1;
+        for (int k = 0; k < n; k++) {
+            while (pending < width) {
+                accumulator |= (uint64_t)in[pos++] << pending;
+                pending += 8;
+            }
+            uint32_t zigzag = (uint32_t)accumulator & mask;
+            accumulator >>= width;
+            pending -= width;
+            value += (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+            counts[start + k] = value;
+        }
+    }
+    return pos;
+}
+
+size_t compressWaveform(const SeismicActivitySample *samples, int count, unsigned char *out) {
+    CompressedWaveformHeader header;
+    size_t pos = sizeof(header);
+
+    header.baseTimestamp = samples[0].timestamp;
+    quantizeSamples(samples, count, header.baseTimestamp);
+    for (int c = 0; c < WAVEFORM_CHANNELS; c++) {
+        header.first[c] = waveformCounts[c][0];
+        header.last[c] = waveformCounts[c][count - 1];
+        pos += encodeChannel(waveformCounts[c], count, out + pos);
+    }
+    memcpy(out, &header, sizeof(header));
+    return pos;
+}
+
+// Returns 0 when the payload is malformed or does not integrate back to the stored
+// last sample of every channel.
+int decompressWaveform(const unsigned char *in, size_t length, int count, SeismicActivitySample *samples) {
+    CompressedWaveformHeader header;
+    size_t pos = sizeof(header);
+    if (length < sizeof(header)) {
+        return 0;
+    }
+    memcpy(&header, in, sizeof(header));
+
+    for (int c = 0; c < WAVEFORM_CHANNELS; c++) {
+        size_t used = decodeChannel(in + pos, length - pos, count, header.first[c], waveformCounts[c]);
+        if (used == 0 || waveformCounts[c][count - 1] != header.last[c]) {
+            return 0;
+        }
+        pos += used;
+    }
+
+    for (int i = 0; i < count; i++) {
+        samples[i].timestamp = header.baseTimestamp + waveformCounts[0][i] / COUNTS_PER_SECOND;
+        samples[i].displacement = waveformCounts[1][i] / COUNTS_PER_UNIT;
+        samples[i].acceleration = waveformCounts[2][i] / COUNTS_PER_UNIT;
+        for (int c = 0; c < MULTI_SENSOR_COUNT; c++) {
+            samples[i].sensorData[c] = waveformCounts[3 + c][i] / COUNTS_PER_UNIT;
+        }
+    }
+    return 1;
+}
+
+uint32_t walRecordCrc(const WalRecordHeader *header, const unsigned char *payload) {
+    uint32_t crc = updateCrc(0, &header->sequence, sizeof(header->sequence));
+    crc = updateCrc(crc, &header->sampleCount, sizeof(header->sampleCount));
+    crc = updateCrc(crc, &header->payloadBytes, sizeof(header->payloadBytes));
+    return updateCrc(crc, payload, header->payloadBytes);
+}
+
+// Scans every intact record and truncates the file after the last good one, so an append
+// interrupted by a crash never leaves garbage in front of new records. When
+// restoreSamples is set the payloads are replayed into data[]. Returns the record count.
+int recoverWriteAheadLog(const char *path, int restoreSamples) {
+    static SeismicActivitySample samples[MAX_EVENT_SAMPLES];
+    FILE *file = fopen(path, "rb");
+    long goodOffset = 0;
+    int records = 0;
+    WalRecordHeader header;
+
+    if (file == NULL) {
+        return 0;
+    }
+    if (fread(&header, sizeof(header), 1, file) == 1 && header.magic != WAL_RECORD_MAGIC &&
+        (header.magic & WAL_MAGIC_PREFIX_MASK) == WAL_MAGIC_PREFIX) {
+        char oldPath[256];
         fclose(file);
-    } else {
+        snprintf(oldPath, sizeof(oldPath), "%s.v%c", path, (char)(header.magic & 0xFF));
+        printf("%s uses log format %c, this build writes %d; moving it to %s.\n",
+               path, (char)(header.magic & 0xFF), WAL_FORMAT_VERSION, oldPath);
+        if (rename(path, oldPath) != 0) {
+            printf("Error moving old log file aside.\n");
+        }
+        return 0;
+    }
+    rewind(file);
+    while (fread(&header, sizeof(header), 1, file) == 1) {
+        if (header.magic != WAL_RECORD_MAGIC || header.sequence != (uint64_t)records ||
+            header.sampleCount == 0 || header.sampleCount > MAX_EVENT_SAMPLES ||
+            header.payloadBytes > MAX_COMPRESSED_BYTES ||
+            fread(compressedBuffer, 1, header.payloadBytes, file) != header.payloadBytes ||
+            header.crc != walRecordCrc(&header, compressedBuffer) ||
+            !decompressWaveform(compressedBuffer, header.payloadBytes, (int)header.sampleCount, samples)) {
+            break;
+        }
+        for (uint32_t i = 0; restoreSamples && i < header.sampleCount && dataIndex < MAX_SAMPLES; i++) {
+            data[dataIndex++] = samples[i];
+        }
+        records++;
+        goodOffset = ftell(file);
+    }
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fclose(file);
+
+    if (fileSize > goodOffset) {
+        printf("Truncating %ld bytes of torn log tail from %s.\n", fileSize - goodOffset, path);
+        file = fopen(path, "r+b");
+        if (file == NULL || ftruncate(fileno(file), goodOffset) != 0) {
+            printf("Error truncating log file.\n");
+        }
+        if (file != NULL) {
+            fclose(file);
+        }
+    }
+    printf("Recovered %d records from %s\n", records, path);
+    return records;
+}
+
+int openWriteAheadLog(WriteAheadLog *log, const char *path, int nextSequence) {
+    log->file = fopen(path, "ab");
+    if (log->file == NULL) {
         printf("Error opening log file.\n");
+        return 0;
+    }
+    log->nextSequence = (uint64_t)nextSequence;
+    log->pendingSync = 0;
+    return 1;
+}
+
+void syncWriteAheadLog(WriteAheadLog *log) {
+    if (log->file != NULL && log->pendingSync > 0) {
+        fflush(log->file);
+        fsync(fileno(log->file));
+        log->pendingSync = 0;
+    }
+}
+
+void appendWriteAheadLog(WriteAheadLog *log, const SeismicActivitySample *samples, int count) {
+    WalRecordHeader header;
+    header.magic = WAL_RECORD_MAGIC;
+    header.sequence = log->nextSequence++;
+    header.sampleCount = (uint32_t)count;
+    header.payloadBytes = (uint32_t)compressWaveform(samples, count, compressedBuffer);
+    header.crc = walRecordCrc(&header, compressedBuffer);
+    fwrite(&header, sizeof(header), 1, log->file);
+    fwrite(compressedBuffer, 1, header.payloadBytes, log->file);
+    rawBytesWritten += (long)(count * sizeof(*samples));
+    compressedBytesWritten += (long)(sizeof(header) + header.payloadBytes);
+    if (++log->pendingSync >= WAL_SYNC_BATCH) {
+        syncWriteAheadLog(log);
+    }
+}
+
+void closeWriteAheadLog(WriteAheadLog *log) {
+    syncWriteAheadLog(log);
+    if (log->file != NULL) {
+        fclose(log->file);
+        log->file = NULL;
+    }
+}
+
+void initializeEventRecorder(EventRecorder *recorder) {
+    recorder->preTriggerStart = 0;
+    recorder->preTriggerCount = 0;
+    recorder->eventSampleCount = 0;
+    recorder->postTriggerRemaining = 0;
+    recorder->recording = 0;
+    recorder->samplesSeen = 0;
+    recorder->samplesPersisted = 0;
+    recorder->eventsPersisted = 0;
+}
+
+void persistRecordedEvent(EventRecorder *recorder) {
+    if (recorder->eventSampleCount == 0) {
+        return;
+    }
+    appendWriteAheadLog(&eventWal, recorder->eventSamples, recorder->eventSampleCount);
+    syncWriteAheadLog(&eventWal);
+    printf("Event record persisted: %d samples from timestamp %.2f to %.2f\n",
+           recorder->eventSampleCount, recorder->eventSamples[0].timestamp,
+           recorder->eventSamples[recorder->eventSampleCount - 1].timestamp);
+    recorder->samplesPersisted += recorder->eventSampleCount;
+    recorder->eventsPersisted++;
+    recorder->eventSampleCount = 0;
+}
+
+void appendEventSample(EventRecorder *recorder, const SeismicActivitySample *sample) {
+    if (recorder->eventSampleCount == MAX_EVENT_SAMPLES) {
+        persistRecordedEvent(recorder);
+    }
+    recorder->eventSamples[recorder->eventSampleCount++] = *sample;
+}
+
+// A trigger during the post-trigger window extends the open event, so overlapping
+// triggers end up in a single record. The recorder uses its own fixed trigger level
+// rather than the adaptive alert threshold, which sits below most of the background.
+void feedEventRecorder(EventRecorder *recorder, const SeismicActivitySample *sample) {
+    int triggered = sample->displacement > EVENT_TRIGGER_THRESHOLD;
+    recorder->samplesSeen++;
+
+    if (recorder->recording) {
+        appendEventSample(recorder, sample);
+        if (triggered) {
+            recorder->postTriggerRemaining = POST_TRIGGER_SAMPLES;
+        } else if (--recorder->postTriggerRemaining <= 0) {
+            persistRecordedEvent(recorder);
+            recorder->recording = 0;
+        }
+        return;
+    }
+
+    if (triggered) {
+        for (int i = 0; i < recorder->preTriggerCount; i++) {
+            appendEventSample(recorder, &recorder->preTrigger[(recorder->preTriggerStart + i) % PRE_TRIGGER_SAMPLES]);
+        }
+        recorder->preTriggerStart = 0;
+        recorder->preTriggerCount = 0;
+        appendEventSample(recorder, sample);
+        recorder->postTriggerRemaining = POST_TRIGGER_SAMPLES;
+        recorder->recording = 1;
+        return;
+    }
+
+    int slot = (recorder->preTriggerStart + recorder->preTriggerCount) % PRE_TRIGGER_SAMPLES;
+    recorder->preTrigger[slot] = *sample;
+    if (recorder->preTriggerCount < PRE_TRIGGER_SAMPLES) {
+        recorder->preTriggerCount++;
+    } else {
+        recorder->preTriggerStart = (recorder->preTriggerStart + 1) % PRE_TRIGGER_SAMPLES;
+    }
+}
+
+void flushContinuousLog() {
+    if (wal.file != NULL && loggedIndex > walBatchStart) {
+        appendWriteAheadLog(&wal, &data[walBatchStart], loggedIndex - walBatchStart);
+    }
+    walBatchStart = loggedIndex;
+}
+
+// Persists only the samples recorded since the previous call: every sample in
+// continuous mode, batched CONTINUOUS_RECORD_SAMPLES per record so compression has
+// something to work with, or just the trigger windows in event mode.
+void logDataToFile() {
+    if (recordingMode == RECORD_EVENTS) {
+        for (; loggedIndex < dataIndex; loggedIndex++) {
+            feedEventRecorder(&eventRecorder, &data[loggedIndex]);
+        }
+        return;
+    }
+    loggedIndex = dataIndex;
+    while (wal.file != NULL && loggedIndex - walBatchStart >= CONTINUOUS_RECORD_SAMPLES) {
+        appendWriteAheadLog(&wal, &data[walBatchStart], CONTINUOUS_RECORD_SAMPLES);
+        walBatchStart += CONTINUOUS_RECORD_SAMPLES;
     }
 }
 
@@ -165,11 +593,46 @@ void monitorSeismicActivity() {
     analyzeSeismicData();
 }
 
-int main() {
+int main(int argc, char **argv) {
+    if (argc > 2 && strcmp(argv[1], "--mode") == 0 && strcmp(argv[2], "continuous") == 0) {
+        recordingMode = RECORD_CONTINUOUS;
+    } else if (argc > 2 && strcmp(argv[1], "--mode") == 0 && strcmp(argv[2], "events") == 0) {
+        recordingMode = RECORD_EVENTS;
+    } else if (argc > 1) {
+        fprintf(stderr, "Usage: %s [--mode continuous|events]\n", argv[0]);
+        return 1;
+    }
     printf("Seismic activity prediction system started.\n");
     calibrateSensor();
+    initializeCrcTable();
+
+    if (recordingMode == RECORD_EVENTS) {
+        initializeEventRecorder(&eventRecorder);
+        if (!openWriteAheadLog(&eventWal, EVENT_WAL_FILE, recoverWriteAheadLog(EVENT_WAL_FILE, 0))) {
+            return 1;
+        }
+    } else if (!openWriteAheadLog(&wal, WAL_FILE, recoverWriteAheadLog(WAL_FILE, 1))) {
+        return 1;
+    }
+    loggedIndex = dataIndex;
+    walBatchStart = dataIndex;
 
     monitorSeismicActivity();
 
+    if (recordingMode == RECORD_EVENTS) {
+        persistRecordedEvent(&eventRecorder);
+        printf("Event recorder: %ld of %ld samples persisted in %ld events, %ld quiet samples skipped\n",
+               eventRecorder.samplesPersisted, eventRecorder.samplesSeen, eventRecorder.eventsPersisted,
+               eventRecorder.samplesSeen - eventRecorder.samplesPersisted);
+        closeWriteAheadLog(&eventWal);
+    } else {
+        flushContinuousLog();
+        closeWriteAheadLog(&wal);
+    }
+    if (compressedBytesWritten > 0) {
+        printf("Waveform storage: %ld bytes raw, %ld bytes compressed (%.1fx)\n",
+               rawBytesWritten, compressedBytesWritten, (double)rawBytesWritten / compressedBytesWritten);
+    }
+
     return 0;
 }